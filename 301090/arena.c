@@ -0,0 +1,117 @@
+#define _GNU_SOURCE
+#include "arena.h"
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "numa.h"
+
+#define ARENA_CHUNK_SIZE (64ul << 10)
+#define ARENA_ALIGN alignof(max_align_t)
+
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t arena_key;
+
+static size_t round_up(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+
+static void destroy_arena(void* arena_ptr) {
+    arena_t* arena = (arena_t*) arena_ptr;
+    chunk_t* chunk = arena->first;
+    while (chunk) {
+        chunk_t* next = chunk->next;
+        munmap(chunk, chunk->size);
+        chunk = next;
+    }
+    free(arena);
+}
+
+static void init_arena_key() {
+    pthread_key_create(&arena_key, destroy_arena);
+}
+
+static chunk_t* create_chunk(arena_t* arena, size_t size) {
+    // Bind the chunk to the node of the thread before its pages are touched
+    size_t chunk_size = round_up(sizeof(chunk_t) + size, ARENA_CHUNK_SIZE);
+    void* map = mmap(NULL, chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) return NULL;
+    place_memory_on_node(map, chunk_size, arena->node);
+    chunk_t* chunk = (chunk_t*) map;
+    chunk->next = NULL;
+    chunk->size = chunk_size;
+    chunk->used = round_up(sizeof(chunk_t), ARENA_ALIGN);
+    return chunk;
+}
+
+arena_t* get_thread_arena() {
+    pthread_once(&arena_once, init_arena_key);
+    arena_t* arena = (arena_t*) pthread_getspecific(arena_key);
+    if (arena) return arena;
+    arena = (arena_t*) malloc(sizeof(arena_t));
+    if (!arena) return NULL;
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->node = get_numa_current_node();
+    if (pthread_setspecific(arena_key, arena) != 0) {
+        free(arena);
+        return NULL;
+    }
+    return arena;
+}
+
+void reset_arena(arena_t* arena) {
+    chunk_t* chunk = arena->first;
+    while (chunk) {
+        chunk->used = round_up(sizeof(chunk_t), ARENA_ALIGN);
+        chunk = chunk->next;
+    }
+    arena->current = arena->first;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+    size = round_up(size, ARENA_ALIGN);
+    // Look for room in the current chunk, then in the following (recycled) ones
+    chunk_t* chunk = arena->current;
+    while (chunk && chunk->used + size > chunk->size) {
+        chunk = chunk->next;
+    }
+    if (!chunk) {
+        chunk = create_chunk(arena, size);
+        if (!chunk) return NULL;
+        // Append at the end of the chain
+        if (!arena->first) {
+            arena->first = chunk;
+        } else {
+            chunk_t* last = arena->current ? arena->current : arena->first;
+            while (last->next) last = last->next;
+            last->next = chunk;
+        }
+    }
+    arena->current = chunk;
+    void* res = (char*) chunk + chunk->used;
+    chunk->used += size;
+    return res;
+}
+
+bool reserve_arena(arena_t* arena, size_t size) {
+    // Room left in the current chunk and the following (recycled) ones
+    size_t room = 0;
+    chunk_t* last = NULL;
+    for (chunk_t* chunk = arena->current ? arena->current : arena->first; chunk; chunk = chunk->next) {
+        room += chunk->size - chunk->used;
+        last = chunk;
+    }
+    if (room >= size) return true;
+    // One chunk for the rest, instead of one per ARENA_CHUNK_SIZE while running
+    chunk_t* chunk = create_chunk(arena, size - room);
+    if (!chunk) return false;
+    if (last) {
+        last->next = chunk;
+    } else {
+        arena->first = chunk;
+        arena->current = chunk;
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Per-thread bump allocator for the transaction descriptor and its logs.
+// Chunks are mapped on the NUMA node of the owning thread, recycled at each
+// transaction begin and unmapped when the thread exits, so steady-state
+// transactions neither call malloc nor leak.
+typedef struct chunk {
+    struct chunk* next;
+    size_t size;
+    size_t used;
+} chunk_t;
+
+typedef struct arena {
+    chunk_t* first;
+    chunk_t* current;
+    int node;
+} arena_t;
+
+arena_t* get_thread_arena();
+void reset_arena(arena_t* arena);
+void* arena_alloc(arena_t* arena, size_t size);
+bool reserve_arena(arena_t* arena, size_t size);
+
+#endif /* ARENA_H */
@@ -0,0 +1,149 @@
+#include "heap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_HEAP_SIZE (1ul << 30)
+#define FALLBACK_HEAP_FACTOR 16
+#define FALLBACK_HEAP_MIN_SIZE (16ul << 20)
+
+static size_t round_up(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+
+size_t get_heap_size() {
+    const char* text = getenv("TM_HEAP_SIZE");
+    if (!text) return DEFAULT_HEAP_SIZE;
+    char* end;
+    size_t size = strtoull(text, &end, 10);
+    switch (*end) {
+    case 'G': case 'g':
+        size <<= 10;
+        // Fallthrough
+    case 'M': case 'm':
+        size <<= 10;
+        // Fallthrough
+    case 'K': case 'k':
+        size <<= 10;
+        break;
+    }
+    return size;
+}
+
+// Heap size when committed eagerly: a multiple of the first segment, at least
+// FALLBACK_HEAP_MIN_SIZE, and never more than the lazily mapped one
+size_t get_fallback_heap_size(size_t first_size) {
+    size_t size = first_size * FALLBACK_HEAP_FACTOR;
+    if (size < FALLBACK_HEAP_MIN_SIZE) size = FALLBACK_HEAP_MIN_SIZE;
+    size_t max_size = get_heap_size();
+    return size < max_size ? size : max_size;
+}
+
+bool init_heap(heap_t* heap, void* start, size_t size, size_t align) {
+    if (pthread_mutex_init(&(heap->lock), NULL) != 0) return false;
+    heap->start = (char*) start;
+    heap->size = size;
+    heap->top = 0;
+    heap->header_size = round_up(sizeof(block_header_t), align);
+    heap->bins = NULL;
+    return true;
+}
+
+void fini_heap(heap_t* heap) {
+    bin_t* bin = heap->bins;
+    while (bin) {
+        bin_t* next = bin->next;
+        free(bin->blocks);
+        free(bin);
+        bin = next;
+    }
+    heap->bins = NULL;
+    pthread_mutex_destroy(&(heap->lock));
+}
+
+static bin_t* get_bin(heap_t* heap, size_t size, bool create) {
+    for (bin_t* bin = heap->bins; bin; bin = bin->next) {
+        if (bin->size == size) return bin;
+    }
+    if (!create) return NULL;
+    bin_t* bin = (bin_t*) calloc(1, sizeof(bin_t));
+    if (!bin) return NULL;
+    bin->size = size;
+    bin->next = heap->bins;
+    heap->bins = bin;
+    return bin;
+}
+
+void* alloc_block(heap_t* heap, size_t size, size_t align) {
+    size = round_up(size, align);
+    char* segment = NULL;
+    pthread_mutex_lock(&(heap->lock));
+    // Recycle a freed segment of the same size, or carve a new one at the top
+    bin_t* bin = get_bin(heap, size, false);
+    if (bin && bin->count > 0) {
+        segment = bin->blocks[--bin->count];
+    } else if (heap->top + heap->header_size + size <= heap->size) {
+        segment = heap->start + heap->top + heap->header_size;
+        block_header_t* header = (block_header_t*) (segment - heap->header_size);
+        header->size = size;
+        header->live = 0;
+        heap->top += heap->header_size + size;
+    }
+    pthread_mutex_unlock(&(heap->lock));
+    // Not reachable from any committed state, so no transaction reads it
+    if (segment) memset(segment, 0, size);
+    return segment;
+}
+
+void release_block(heap_t* heap, void* segment) {
+    block_header_t* header = get_block_header(heap, segment);
+    pthread_mutex_lock(&(heap->lock));
+    bin_t* bin = get_bin(heap, header->size, true);
+    if (bin && bin->count == bin->capacity) {
+        size_t capacity = bin->capacity ? 2 * bin->capacity : 16;
+        char** blocks = (char**) realloc(bin->blocks, capacity * sizeof(char*));
+        if (blocks) {
+            bin->blocks = blocks;
+            bin->capacity = capacity;
+        }
+    }
+    // Out of memory for the bookkeeping: the segment is leaked, not corrupted
+    if (bin && bin->count < bin->capacity) {
+        bin->blocks[bin->count++] = (char*) segment;
+    }
+    pthread_mutex_unlock(&(heap->lock));
+}
+
+block_header_t* get_block_header(heap_t* heap, void* segment) {
+    return (block_header_t*) ((char*) segment - heap->header_size);
+}
+
+bool is_heap_block(heap_t* heap, void* segment) {
+    char* address = (char*) segment;
+    pthread_mutex_lock(&(heap->lock));
+    bool res = address >= heap->start + heap->header_size && address < heap->start + heap->top;
+    pthread_mutex_unlock(&(heap->lock));
+    return res;
+}
+
+size_t get_heap_top(heap_t* heap) {
+    pthread_mutex_lock(&(heap->lock));
+    size_t top = heap->top;
+    pthread_mutex_unlock(&(heap->lock));
+    return top;
+}
+
+// Segment whose block (header included) holds the address, NULL if none
+void* find_heap_segment(heap_t* heap, const void* address) {
+    const char* target = (const char*) address;
+    size_t top = get_heap_top(heap);
+    if (target < heap->start || target >= heap->start + top) return NULL;
+    // Blocks only grow the heap, so a walk from the start follows their headers
+    char* block = heap->start;
+    while (block < heap->start + top) {
+        char* next = block + heap->header_size + ((block_header_t*) block)->size;
+        if (target < next) return block + heap->header_size;
+        block = next;
+    }
+    return NULL;
+}
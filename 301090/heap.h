@@ -0,0 +1,52 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Segments allocated with tm_alloc, carved from a reserved range right after
+// the first segment so that a single lock table covers every shared word.
+// Each segment is preceded by a header (padded to the region alignment),
+// written at commit time like any other shared word. Segments are never split
+// nor merged: freed ones are recycled for allocations of the same size, so the
+// heap always reads as a sequence of [header | segment] blocks up to its top.
+// The reserved range is set with TM_HEAP_SIZE (bytes, K/M/G suffix allowed,
+// default 1G); being mapped lazily, only used blocks consume memory. When no
+// lazy mapping can be made, the range is committed eagerly and is instead
+// sized from the first segment (see get_fallback_heap_size).
+typedef struct block_header {
+    uint64_t size;  // Size of the segment
+    uint64_t live;  // Whether the allocation is committed and not freed
+} block_header_t;
+
+typedef struct bin {
+    struct bin* next;
+    size_t size;
+    size_t count;
+    size_t capacity;
+    char** blocks;
+} bin_t;
+
+typedef struct heap {
+    pthread_mutex_t lock;
+    char* start;
+    size_t size;
+    size_t top;         // Bytes used from start
+    size_t header_size;
+    bin_t* bins;        // Freed segments, by size
+} heap_t;
+
+size_t get_heap_size();
+size_t get_fallback_heap_size(size_t first_size);
+bool init_heap(heap_t* heap, void* start, size_t size, size_t align);
+void fini_heap(heap_t* heap);
+void* alloc_block(heap_t* heap, size_t size, size_t align);
+void release_block(heap_t* heap, void* segment);
+block_header_t* get_block_header(heap_t* heap, void* segment);
+bool is_heap_block(heap_t* heap, void* segment);
+size_t get_heap_top(heap_t* heap);
+void* find_heap_segment(heap_t* heap, const void* address);
+
+#endif /* HEAP_H */
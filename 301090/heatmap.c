@@ -0,0 +1,152 @@
+#define _GNU_SOURCE
+#include "heatmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEATMAP_PROBES 32 // Entries probed before dropping a stripe
+
+typedef struct spot {
+    uint64_t first;   // First stripe
+    uint64_t last;    // Last stripe (inclusive)
+    uint64_t reads;
+    uint64_t commits;
+} spot_t;
+
+static size_t get_env_size(const char* name, size_t fallback) {
+    const char* text = getenv(name);
+    if (!text) return fallback;
+    size_t value = strtoull(text, NULL, 10);
+    return value > 0 ? value : fallback;
+}
+
+bool init_heatmap(heatmap_t* heatmap) {
+    heatmap->path = NULL;
+    heatmap->table = NULL;
+    atomic_init(&(heatmap->dropped), 0);
+    const char* path = getenv("TM_HEATMAP");
+    if (!path || !*path) return true;
+    heatmap->path = strdup(path);
+    heatmap->table = (heat_t*) calloc(HEATMAP_SIZE, sizeof(heat_t));
+    if (!heatmap->path || !heatmap->table) {
+        fini_heatmap(heatmap);
+        return false;
+    }
+    heatmap->sample = get_env_size("TM_HEATMAP_SAMPLE", 1);
+    heatmap->top = get_env_size("TM_HEATMAP_TOP", 20);
+    return true;
+}
+
+void fini_heatmap(heatmap_t* heatmap) {
+    free(heatmap->path);
+    free(heatmap->table);
+    heatmap->path = NULL;
+    heatmap->table = NULL;
+}
+
+void record_conflict(heatmap_t* heatmap, uint64_t stripe, bool at_commit) {
+    static _Thread_local size_t countdown = 0;
+    if (countdown > 0) {
+        countdown--;
+        return;
+    }
+    countdown = heatmap->sample - 1;
+
+    uint64_t key = stripe + 1;
+    size_t index = (size_t) ((key * UINT64_C(0x9e3779b97f4a7c15)) >> 32);
+    for (size_t probe = 0; probe < HEATMAP_PROBES; probe++) {
+        heat_t* heat = &(heatmap->table[(index + probe) & (HEATMAP_SIZE - 1)]);
+        uint64_t current = atomic_load_explicit(&(heat->key), memory_order_relaxed);
+        if (current == 0 && atomic_compare_exchange_strong_explicit(&(heat->key), &current, key, memory_order_relaxed, memory_order_relaxed)) {
+            current = key;
+        }
+        if (current != key) continue;
+        atomic_fetch_add_explicit(at_commit ? &(heat->commits) : &(heat->reads), 1, memory_order_relaxed);
+        return;
+    }
+    atomic_fetch_add_explicit(&(heatmap->dropped), 1, memory_order_relaxed);
+}
+
+static int compare_by_count(const void* a, const void* b) {
+    const spot_t* x = (const spot_t*) a;
+    const spot_t* y = (const spot_t*) b;
+    uint64_t cx = x->reads + x->commits;
+    uint64_t cy = y->reads + y->commits;
+    if (cx != cy) return cx < cy ? 1 : -1;
+    return x->first < y->first ? -1 : x->first > y->first;
+}
+
+static int compare_by_stripe(const void* a, const void* b) {
+    const spot_t* x = (const spot_t*) a;
+    const spot_t* y = (const spot_t*) b;
+    return x->first < y->first ? -1 : x->first > y->first;
+}
+
+// Locate an address: offset of its segment in the region (0 for the first
+// one) and its offset in the segment (negative in a segment header)
+static void locate(void* start, heap_t* heap, const char* address, long long* segment, long long* offset) {
+    const char* base = (const char*) find_heap_segment(heap, address);
+    if (!base) base = (const char*) start;
+    *segment = base - (const char*) start;
+    *offset = address - base;
+}
+
+bool write_heatmap(heatmap_t* heatmap, void* start, size_t align, heap_t* heap) {
+    if (!heatmap->table) return true;
+    spot_t* spots = (spot_t*) malloc(HEATMAP_SIZE * sizeof(spot_t));
+    if (!spots) return false;
+    size_t count = 0;
+    uint64_t total = 0;
+    for (size_t i = 0; i < HEATMAP_SIZE; i++) {
+        heat_t* heat = &(heatmap->table[i]);
+        uint64_t key = atomic_load_explicit(&(heat->key), memory_order_relaxed);
+        if (key == 0) continue;
+        spot_t* spot = &(spots[count++]);
+        spot->first = spot->last = key - 1;
+        spot->reads = atomic_load_explicit(&(heat->reads), memory_order_relaxed);
+        spot->commits = atomic_load_explicit(&(heat->commits), memory_order_relaxed);
+        total += spot->reads + spot->commits;
+    }
+    FILE* file = fopen(heatmap->path, "w");
+    if (!file) {
+        free(spots);
+        return false;
+    }
+
+    // Stripes, hottest first
+    fprintf(file, "# %llu sampled aborts (1 in %zu), %llu of untracked stripes\n", (unsigned long long) total, heatmap->sample, (unsigned long long) atomic_load(&(heatmap->dropped)));
+    fprintf(file, "# stripe region_offset segment segment_offset aborts reads commits\n");
+    qsort(spots, count, sizeof(spot_t), compare_by_count);
+    for (size_t i = 0; i < count; i++) {
+        const char* address = (const char*) start + spots[i].first * align;
+        long long segment, offset;
+        locate(start, heap, address, &segment, &offset);
+        fprintf(file, "%llu %lld %lld %lld %llu %llu %llu\n", (unsigned long long) spots[i].first, (long long) (address - (const char*) start), segment, offset,
+                (unsigned long long) (spots[i].reads + spots[i].commits), (unsigned long long) spots[i].reads, (unsigned long long) spots[i].commits);
+    }
+
+    // Ranges of adjacent stripes, hottest first
+    qsort(spots, count, sizeof(spot_t), compare_by_stripe);
+    size_t ranges = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (ranges > 0 && spots[ranges - 1].last + 1 == spots[i].first) {
+            spots[ranges - 1].last = spots[i].first;
+            spots[ranges - 1].reads += spots[i].reads;
+            spots[ranges - 1].commits += spots[i].commits;
+        } else {
+            spots[ranges++] = spots[i];
+        }
+    }
+    qsort(spots, ranges, sizeof(spot_t), compare_by_count);
+    fprintf(file, "# top %zu ranges: first_stripe last_stripe segment segment_offset size aborts reads commits\n", heatmap->top);
+    for (size_t i = 0; i < ranges && i < heatmap->top; i++) {
+        long long segment, offset;
+        locate(start, heap, (const char*) start + spots[i].first * align, &segment, &offset);
+        fprintf(file, "%llu %llu %lld %lld %llu %llu %llu %llu\n", (unsigned long long) spots[i].first, (unsigned long long) spots[i].last, segment, offset,
+                (unsigned long long) ((spots[i].last - spots[i].first + 1) * align), (unsigned long long) (spots[i].reads + spots[i].commits),
+                (unsigned long long) spots[i].reads, (unsigned long long) spots[i].commits);
+    }
+    free(spots);
+    return fclose(file) == 0;
+}
@@ -0,0 +1,36 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "heap.h"
+
+// Conflict heatmap: the aborts of the region are attributed to the stripe of
+// the conflicting lock, and written out sorted by count at tm_destroy, to the
+// file named by TM_HEATMAP (no table nor recording if unset), followed by the
+// hottest ranges of adjacent stripes. TM_HEATMAP_SAMPLE=n records one abort in
+// n per thread (default 1), TM_HEATMAP_TOP is the number of ranges (default 20).
+#define HEATMAP_SIZE 4096 // Stripes tracked (power of 2), further ones are dropped
+
+typedef struct heat {
+    _Atomic uint64_t key;      // Stripe index + 1 (0: free entry)
+    _Atomic uint64_t reads;    // Aborts of reads
+    _Atomic uint64_t commits;  // Aborts of commits
+} heat_t;
+
+typedef struct heatmap {
+    char* path;
+    heat_t* table;
+    size_t sample;
+    size_t top;
+    _Atomic uint64_t dropped;  // Sampled aborts of untracked stripes
+} heatmap_t;
+
+bool init_heatmap(heatmap_t* heatmap);
+void fini_heatmap(heatmap_t* heatmap);
+void record_conflict(heatmap_t* heatmap, uint64_t stripe, bool at_commit);
+bool write_heatmap(heatmap_t* heatmap, void* start, size_t align, heap_t* heap);
+
+#endif /* HEATMAP_H */
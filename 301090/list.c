@@ -5,19 +5,27 @@
 list_t* create_list() {
     list_t* list = (list_t*) malloc(sizeof(list_t));
     if (!list) return NULL;
-    list->first = NULL;
-    list->last = NULL;
-    list->size = 0;
+    init_list(list);
     return list;
 }
 
 node_t* create_node(void* content) {
     node_t* node = (node_t*) malloc(sizeof(node_t));
     if (!node) return NULL;
+    init_node(node, content);
+    return node;
+}
+
+void init_list(list_t* list) {
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+}
+
+void init_node(node_t* node, void* content) {
     node->previous = NULL;
     node->next = NULL;
     node->content = content;
-    return node;
 }
 
 void add_node(list_t* list, node_t* node) {
@@ -33,6 +41,22 @@ void add_node(list_t* list, node_t* node) {
     list->size += 1;
 }
 
+void remove_node(list_t* list, node_t* node) {
+    if (node->previous) {
+        node->previous->next = node->next;
+    } else {
+        list->first = node->next;
+    }
+    if (node->next) {
+        node->next->previous = node->previous;
+    } else {
+        list->last = node->previous;
+    }
+    node->previous = NULL;
+    node->next = NULL;
+    list->size -= 1;
+}
+
 void destroy_list(list_t* list, void (*destroy_node)(node_t*)) {
     node_t* node = list->first;
     while (node) {
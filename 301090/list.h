@@ -15,7 +15,10 @@ typedef struct list {
 
 list_t* create_list();
 node_t* create_node(void* content);
+void init_list(list_t* list);
+void init_node(node_t* node, void* content);
 void add_node(list_t* list, node_t* node);
+void remove_node(list_t* list, node_t* node);
 void destroy_list(list_t* list, void (*destroy_node)(node_t*));
 
 #endif /* LIST_H */
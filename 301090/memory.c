@@ -0,0 +1,176 @@
+#define _GNU_SOURCE
+#include "memory.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define DEFAULT_HUGE_PAGE_SIZE (2ul << 20)
+
+static size_t get_huge_page_size() {
+    size_t size = 0;
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo) {
+        char line[128];
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (sscanf(line, "Hugepagesize: %zu kB", &size) == 1) {
+                size *= 1024;
+                break;
+            }
+        }
+        fclose(meminfo);
+    }
+    return size ? size : DEFAULT_HUGE_PAGE_SIZE;
+}
+
+static size_t round_up(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+
+size_t get_page_size() {
+    return (size_t) sysconf(_SC_PAGESIZE);
+}
+
+memory_mode_t get_memory_mode() {
+    const char* mode = getenv("TM_HUGE_PAGES");
+    if (!mode) return MEMORY_PAGES;
+    if (strcmp(mode, "thp") == 0) return MEMORY_THP;
+    if (strcmp(mode, "hugetlb") == 0) return MEMORY_HUGETLB;
+    return MEMORY_PAGES;
+}
+
+const char* memory_mode_name(memory_mode_t mode) {
+    switch (mode) {
+    case MEMORY_THP:
+        return "thp";
+    case MEMORY_HUGETLB:
+        return "hugetlb";
+    case MEMORY_HEAP:
+        return "heap";
+    case MEMORY_FILE:
+        return "file";
+    default:
+        return "off";
+    }
+}
+
+static bool alloc_hugetlb(memory_t* memory, size_t size) {
+#ifdef MAP_HUGETLB
+    size_t huge_page_size = get_huge_page_size();
+    size_t map_size = round_up(size, huge_page_size);
+    void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_HUGETLB, -1, 0);
+    if (map == MAP_FAILED) return false;
+    memory->start = map;
+    memory->map_start = map;
+    memory->map_size = map_size;
+    memory->page_size = huge_page_size;
+    memory->mode = MEMORY_HUGETLB;
+    return true;
+#else
+    (void) memory;
+    (void) size;
+    return false;
+#endif
+}
+
+static bool alloc_mapping(memory_t* memory, size_t size, size_t align, memory_mode_t mode) {
+    // Over-map by the alignment when it exceeds the page size to align the
+    // start, then give the unaligned head and the tail back. The mapping is not
+    // reserved: pages only get committed (and zeroed) by the kernel on first touch.
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t map_size = round_up(size, align > page_size ? align : page_size);
+    size_t extra = align > page_size ? align : 0;
+    void* map = mmap(NULL, map_size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (map == MAP_FAILED) return false;
+    uintptr_t start = (uintptr_t) map;
+    if (extra > 0) {
+        start = round_up(start, align);
+        size_t head = start - (uintptr_t) map;
+        if (head > 0) munmap(map, head);
+        if (extra - head > 0) munmap((void*) (start + map_size), extra - head);
+    }
+    memory->start = (void*) start;
+    memory->map_start = (void*) start;
+    memory->map_size = map_size;
+    memory->page_size = page_size;
+    memory->mode = mode;
+    return true;
+}
+
+static bool alloc_thp(memory_t* memory, size_t size, size_t align) {
+    size_t huge_page_size = get_huge_page_size();
+    if (!alloc_mapping(memory, size, align > huge_page_size ? align : huge_page_size, MEMORY_THP)) return false;
+#ifdef MADV_HUGEPAGE
+    madvise(memory->map_start, memory->map_size, MADV_HUGEPAGE); // Best effort, THP may be disabled
+#endif
+    memory->page_size = huge_page_size;
+    return true;
+}
+
+static bool alloc_pages(memory_t* memory, size_t size, size_t align) {
+    return alloc_mapping(memory, size, align, MEMORY_PAGES);
+}
+
+static bool alloc_heap(memory_t* memory, size_t size, size_t align) {
+    if (posix_memalign(&(memory->start), align, size) != 0) return false;
+    memset(memory->start, 0, size);
+    memory->map_start = NULL;
+    memory->map_size = 0;
+    memory->page_size = 0;
+    memory->mode = MEMORY_HEAP;
+    return true;
+}
+
+bool alloc_lazy_memory(memory_t* memory, size_t size, size_t align, memory_mode_t mode) {
+    // Each mode falls back to the next one: hugetlb -> thp -> pages
+    switch (mode) {
+    case MEMORY_HUGETLB:
+        if (alloc_hugetlb(memory, size)) return true;
+        // Fallthrough
+    case MEMORY_THP:
+        if (alloc_thp(memory, size, align)) return true;
+        // Fallthrough
+    case MEMORY_PAGES:
+        return alloc_pages(memory, size, align);
+    default:
+        return false;
+    }
+}
+
+bool alloc_memory(memory_t* memory, size_t size, size_t align, memory_mode_t mode) {
+    // Last resort after the mappings: the heap, committed and zeroed eagerly
+    if (alloc_lazy_memory(memory, size, align, mode)) return true;
+    return alloc_heap(memory, size, align);
+}
+
+bool alloc_file_memory(memory_t* memory, int fd, size_t size, size_t extra) {
+    // Private: stores stay in memory, the file is only updated from the redo log
+    size_t page_size = get_page_size();
+    size_t file_size = round_up(size, page_size);
+    size_t map_size = file_size + round_up(extra, page_size);
+    void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (map == MAP_FAILED) return false;
+    if (mmap(map, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, fd, 0) == MAP_FAILED) {
+        munmap(map, map_size);
+        return false;
+    }
+    memory->start = map;
+    memory->map_start = map;
+    memory->map_size = map_size;
+    memory->page_size = page_size;
+    memory->mode = MEMORY_FILE;
+    return true;
+}
+
+void free_memory(memory_t* memory) {
+    if (!memory->start) return;
+    if (memory->mode == MEMORY_HEAP) {
+        free(memory->start);
+    } else {
+        munmap(memory->map_start, memory->map_size);
+    }
+    memory->start = NULL;
+}
@@ -0,0 +1,40 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Backing of the large allocations (shared memory, lock array), selected at
+// tm_create with the TM_HUGE_PAGES environment variable:
+//   unset/"off": anonymous mmap with regular pages
+//   "thp":       anonymous mmap, aligned on and advised for transparent huge pages
+//   "hugetlb":   anonymous mmap from the hugetlbfs pool, falling back to "thp"
+// Allocated memory is always zero-filled. Mappings are populated lazily on
+// first touch, so allocating and freeing them does not depend on their size.
+typedef enum memory_mode {
+    MEMORY_PAGES,
+    MEMORY_THP,
+    MEMORY_HUGETLB,
+    MEMORY_HEAP, // Fallback only, when no mapping could be made
+    MEMORY_FILE  // Private mapping of a file (durable regions)
+} memory_mode_t;
+
+typedef struct memory {
+    void* start;         // Start of the usable memory
+    void* map_start;     // Start of the mapping (mmap modes only)
+    size_t map_size;     // Size of the mapping (mmap modes only)
+    size_t page_size;    // Size of the pages backing the mapping (mmap modes only)
+    memory_mode_t mode;  // Mode actually used
+} memory_t;
+
+size_t get_page_size();
+memory_mode_t get_memory_mode();
+bool alloc_memory(memory_t* memory, size_t size, size_t align, memory_mode_t mode);
+// Same, without the eager heap fallback: fails rather than commit size bytes
+bool alloc_lazy_memory(memory_t* memory, size_t size, size_t align, memory_mode_t mode);
+// Map the file over the first size bytes, followed by extra bytes of anonymous memory
+bool alloc_file_memory(memory_t* memory, int fd, size_t size, size_t extra);
+void free_memory(memory_t* memory);
+const char* memory_mode_name(memory_mode_t mode);
+
+#endif /* MEMORY_H */
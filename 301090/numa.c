@@ -0,0 +1,111 @@
+#define _GNU_SOURCE
+#include "numa.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Memory policy modes and flags, from <linux/mempolicy.h>
+#define NUMA_MPOL_PREFERRED 1
+#define NUMA_MPOL_INTERLEAVE 3
+#define NUMA_MPOL_LOCAL 4
+#define NUMA_MPOL_F_MEMS_ALLOWED (1 << 2)
+
+#define NUMA_MAX_NODES 1024
+#define NUMA_MASK_BITS (8 * sizeof(unsigned long))
+#define NUMA_MASK_WORDS (NUMA_MAX_NODES / NUMA_MASK_BITS)
+
+static pthread_once_t nodes_once = PTHREAD_ONCE_INIT;
+static unsigned long allowed_mask[NUMA_MASK_WORDS]; // Nodes the process may allocate on
+static int allowed_nodes[NUMA_MAX_NODES];
+static int allowed_count = 1;
+
+static void init_nodes() {
+    if (syscall(SYS_get_mempolicy, NULL, allowed_mask, NUMA_MAX_NODES, NULL, NUMA_MPOL_F_MEMS_ALLOWED) != 0) {
+        // No NUMA support in the kernel: behave as a single-node host
+        memset(allowed_mask, 0, sizeof(allowed_mask));
+        allowed_mask[0] = 1;
+    }
+    int count = 0;
+    for (int node = 0; node < NUMA_MAX_NODES; node++) {
+        if (allowed_mask[node / NUMA_MASK_BITS] & (1ul << (node % NUMA_MASK_BITS))) {
+            allowed_nodes[count++] = node;
+        }
+    }
+    allowed_count = count > 0 ? count : 1;
+}
+
+static long bind_range(void* start, size_t size, int mode, const unsigned long* mask) {
+    return syscall(SYS_mbind, start, size, mode, mask, mask ? NUMA_MAX_NODES : 0, 0);
+}
+
+numa_policy_t get_numa_policy() {
+    const char* policy = getenv("TM_NUMA_POLICY");
+    if (!policy) return NUMA_DEFAULT;
+    if (strcmp(policy, "first-touch") == 0) return NUMA_FIRST_TOUCH;
+    if (strcmp(policy, "interleave") == 0) return NUMA_INTERLEAVE;
+    if (strcmp(policy, "partition") == 0) return NUMA_PARTITION;
+    return NUMA_DEFAULT;
+}
+
+const char* numa_policy_name(numa_policy_t policy) {
+    switch (policy) {
+    case NUMA_FIRST_TOUCH:
+        return "first-touch";
+    case NUMA_INTERLEAVE:
+        return "interleave";
+    case NUMA_PARTITION:
+        return "partition";
+    default:
+        return "default";
+    }
+}
+
+int get_numa_node_count() {
+    pthread_once(&nodes_once, init_nodes);
+    return allowed_count;
+}
+
+int get_numa_current_node() {
+    unsigned int cpu;
+    unsigned int node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return 0;
+    return (int) node;
+}
+
+void place_memory(void* start, size_t size, size_t page_size, numa_policy_t policy) {
+    // Best effort: a refused policy only costs locality, never correctness
+    if (!start || size == 0 || policy == NUMA_DEFAULT) return;
+    if (get_numa_node_count() < 2) return;
+    switch (policy) {
+    case NUMA_FIRST_TOUCH:
+        bind_range(start, size, NUMA_MPOL_LOCAL, NULL);
+        break;
+    case NUMA_INTERLEAVE:
+        bind_range(start, size, NUMA_MPOL_INTERLEAVE, allowed_mask);
+        break;
+    case NUMA_PARTITION: {
+        // One slice per node, rounded to whole pages (the last one takes the rest)
+        size_t slice = (size / allowed_count + page_size - 1) / page_size * page_size;
+        for (int i = 0; i < allowed_count && (size_t) i * slice < size; i++) {
+            size_t offset = (size_t) i * slice;
+            size_t length = i == allowed_count - 1 || offset + slice > size ? size - offset : slice;
+            place_memory_on_node((char*) start + offset, length, allowed_nodes[i]);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void place_memory_on_node(void* start, size_t size, int node) {
+    if (!start || size == 0 || node < 0 || node >= NUMA_MAX_NODES) return;
+    if (get_numa_node_count() < 2) return;
+    unsigned long mask[NUMA_MASK_WORDS];
+    memset(mask, 0, sizeof(mask));
+    mask[node / NUMA_MASK_BITS] = 1ul << (node % NUMA_MASK_BITS);
+    bind_range(start, size, NUMA_MPOL_PREFERRED, mask);
+}
@@ -0,0 +1,28 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <stddef.h>
+
+// Placement of the shared memory and lock array over the NUMA nodes, selected
+// at tm_create with the TM_NUMA_POLICY environment variable:
+//   unset:         process policy (usually first-touch), left untouched
+//   "first-touch": pages go to the node of the thread touching them first
+//   "interleave":  pages are spread round-robin over the allowed nodes
+//   "partition":   the range is cut in one contiguous slice per allowed node
+// Policies are set with the raw mbind/get_mempolicy syscalls (no libnuma
+// dependency) and are no-ops on single-node hosts.
+typedef enum numa_policy {
+    NUMA_DEFAULT,
+    NUMA_FIRST_TOUCH,
+    NUMA_INTERLEAVE,
+    NUMA_PARTITION
+} numa_policy_t;
+
+numa_policy_t get_numa_policy();
+const char* numa_policy_name(numa_policy_t policy);
+int get_numa_node_count();
+int get_numa_current_node();
+void place_memory(void* start, size_t size, size_t page_size, numa_policy_t policy);
+void place_memory_on_node(void* start, size_t size, int node);
+
+#endif /* NUMA_H */
@@ -5,7 +5,7 @@ uint_t increment_and_fetch_tx_id(region_t* region) {
     return val + 1;
 }
 
-int get_locks_start_index(region_t* region, const void* address) {
+size_t get_locks_start_index(region_t* region, const void* address) {
     //return 0;
     void* start = region->start;
     size_t align = region->align;
@@ -14,7 +14,7 @@ int get_locks_start_index(region_t* region, const void* address) {
     return ptrdiff / align;
 }
 
-int get_locks_end_index(region_t* region, const void* address, size_t size) {
+size_t get_locks_end_index(region_t* region, const void* address, size_t size) {
     //return region->size / region->align;
     void* start = region->start;
     size_t align = region->align;
@@ -2,22 +2,38 @@
 #define REGION_H
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdatomic.h>
 #include "global_counter.h"
+#include "heap.h"
+#include "heatmap.h"
+#include "memory.h"
+#include "site.h"
+#include "snapshot.h"
+#include "stats.h"
 #include "versioned_lock.h"
+#include "wal.h"
 #include "own_types.h"
 
 typedef struct region {
     void* start;
     atomic_uint tx_id;
     global_counter_t* counter;
-    versioned_lock_t** locks;
+    versioned_lock_t* locks;
+    memory_t memory;
+    memory_t locks_memory;
+    wal_t* wal;              // Redo log (durable regions only)
+    heap_t heap;             // Segments from tm_alloc, after the first one
+    snapshot_t snapshot;
+    site_t* sites;           // Statistics by transaction site
+    stats_t stats;           // Event counters (USE_STATS builds only)
+    heatmap_t heatmap;       // Aborts by conflicting stripe (if TM_HEATMAP is set)
     size_t size;
     size_t align;
 } region_t;
 
 uint_t increment_and_fetch_tx_id(region_t* region);
-int get_locks_start_index(region_t* region, const void* address);
-int get_locks_end_index(region_t* region, const void* address, size_t size);
+size_t get_locks_start_index(region_t* region, const void* address);
+size_t get_locks_end_index(region_t* region, const void* address, size_t size);
 
 #endif /* REGION_H */
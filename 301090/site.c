@@ -0,0 +1,32 @@
+#include "site.h"
+
+#include <stdlib.h>
+
+site_t* create_sites() {
+    // Zero-filled, i.e. no transaction recorded
+    return (site_t*) calloc(SITE_COUNT, sizeof(site_t));
+}
+
+void destroy_sites(site_t* sites) {
+    free(sites);
+}
+
+site_t* get_site(site_t* sites, uint32_t id) {
+    if (id == 0) return NULL;
+    return &(sites[id % SITE_COUNT]);
+}
+
+static void record_max(_Atomic uint64_t* max, uint64_t value) {
+    uint64_t current = atomic_load_explicit(max, memory_order_relaxed);
+    while (current < value && !atomic_compare_exchange_weak_explicit(max, &current, value, memory_order_relaxed, memory_order_relaxed));
+}
+
+void record_commit(site_t* site, size_t reads, size_t writes) {
+    atomic_fetch_add_explicit(&(site->commits), 1, memory_order_relaxed);
+    record_max(&(site->reads), reads);
+    record_max(&(site->writes), writes);
+}
+
+void record_abort(site_t* site) {
+    atomic_fetch_add_explicit(&(site->aborts), 1, memory_order_relaxed);
+}
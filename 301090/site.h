@@ -0,0 +1,27 @@
+#ifndef SITE_H
+#define SITE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Statistics of the transactions begun with a site ID (tm_begin_hinted), by
+// site. The largest committed log sizes of a site pre-size the logs of its
+// next transactions when they come without size hints. Site IDs are folded
+// into a fixed table, 0 meaning no site.
+#define SITE_COUNT 256
+
+typedef struct site {
+    _Atomic uint64_t commits;
+    _Atomic uint64_t aborts;
+    _Atomic uint64_t reads;   // Largest committed read set
+    _Atomic uint64_t writes;  // Largest committed write set
+} site_t;
+
+site_t* create_sites();
+void destroy_sites(site_t* sites);
+site_t* get_site(site_t* sites, uint32_t id);
+void record_commit(site_t* site, size_t reads, size_t writes);
+void record_abort(site_t* site);
+
+#endif /* SITE_H */
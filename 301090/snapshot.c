@@ -0,0 +1,214 @@
+#define _GNU_SOURCE
+#include "snapshot.h"
+
+#include <sched.h>
+#include <string.h>
+#include "region.h"
+
+#define SNAPSHOT_IDLE 0
+#define SNAPSHOT_PENDING 1
+#define SNAPSHOT_DRAINING 2
+#define SNAPSHOT_ACTIVE 3
+#define SNAPSHOT_BATCH 64   // Stripes captured per call to the sink
+
+#define CONTROL(state, epoch, ts) (((uint64_t) (ts) << 32) | ((uint64_t) (epoch) << 2) | (state))
+#define CONTROL_STATE(control) ((control) & 3)
+#define CONTROL_EPOCH(control) (((control) >> 2) & 0x3fffffff)
+#define CONTROL_TS(control) ((uint_t) ((control) >> 32))
+
+static void snapshot_pause() {
+    sched_yield();
+}
+
+static size_t round_up(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+
+bool init_snapshot(snapshot_t* snapshot, void* base, size_t size) {
+    // Tags start at 0, i.e. captured by the (inexistent) snapshot of epoch 0
+    size_t nb_stripes = round_up(size, SNAPSHOT_STRIPE) / SNAPSHOT_STRIPE;
+    if (!alloc_memory(&(snapshot->stripes_memory), nb_stripes * sizeof(uint64_t), sizeof(uint64_t), MEMORY_PAGES)) return false;
+    if (pthread_mutex_init(&(snapshot->mutex), NULL) != 0) {
+        free_memory(&(snapshot->stripes_memory));
+        return false;
+    }
+    snapshot->stripes = (_Atomic uint64_t*) snapshot->stripes_memory.start;
+    atomic_init(&(snapshot->control), CONTROL(SNAPSHOT_IDLE, 0, 0));
+    atomic_init(&(snapshot->phase), 0);
+    atomic_init(&(snapshot->committing[0]), 0);
+    atomic_init(&(snapshot->committing[1]), 0);
+    atomic_init(&(snapshot->preserving), 0);
+    snapshot->base = (char*) base;
+    snapshot->size = size;
+    snapshot->shadow = NULL;
+    snapshot->shadow_size = 0;
+    return true;
+}
+
+void fini_snapshot(snapshot_t* snapshot) {
+    pthread_mutex_destroy(&(snapshot->mutex));
+    free_memory(&(snapshot->stripes_memory));
+}
+
+void enter_commit(snapshot_t* snapshot, commit_t* commit) {
+    // Register in the current phase, retrying if a snapshot flipped it meanwhile
+    while (true) {
+        unsigned int phase = atomic_load(&(snapshot->phase));
+        atomic_fetch_add(&(snapshot->committing[phase]), 1);
+        if (atomic_load(&(snapshot->phase)) == phase) {
+            commit->phase = phase;
+            commit->counted = true;
+            commit->preserving = false;
+            return;
+        }
+        atomic_fetch_sub(&(snapshot->committing[phase]), 1);
+    }
+}
+
+void prepare_write_back(snapshot_t* snapshot, commit_t* commit, uint_t wv) {
+    uint64_t control = atomic_load(&(snapshot->control));
+    while (CONTROL_STATE(control) == SNAPSHOT_PENDING) {
+        snapshot_pause();
+        control = atomic_load(&(snapshot->control));
+    }
+    // Idle (the next snapshot, if any, gets ts >= wv) or part of the snapshot:
+    // stay counted until the write-back is over
+    if (CONTROL_STATE(control) == SNAPSHOT_IDLE || wv <= CONTROL_TS(control)) return;
+
+    // Not part of the snapshot: let it drain without us, then preserve
+    uint64_t epoch = CONTROL_EPOCH(control);
+    atomic_fetch_sub(&(snapshot->committing[commit->phase]), 1);
+    commit->counted = false;
+    atomic_fetch_add(&(snapshot->preserving), 1);
+    while (true) {
+        control = atomic_load(&(snapshot->control));
+        if (CONTROL_EPOCH(control) != epoch || CONTROL_STATE(control) == SNAPSHOT_IDLE) {
+            // Already over, every stripe it needed is captured
+            atomic_fetch_sub(&(snapshot->preserving), 1);
+            return;
+        }
+        if (CONTROL_STATE(control) == SNAPSHOT_ACTIVE) break;
+        snapshot_pause();
+    }
+    commit->preserving = true;
+    commit->epoch = epoch;
+}
+
+static void capture(snapshot_t* snapshot, uint64_t epoch, size_t stripe) {
+    _Atomic uint64_t* tag = &(snapshot->stripes[stripe]);
+    uint64_t done = 2 * epoch;
+    while (true) {
+        uint64_t current = atomic_load(tag);
+        if (current == done) return;
+        if (current == done + 1) {
+            snapshot_pause();
+            continue;
+        }
+        if (atomic_compare_exchange_weak(tag, &current, done + 1)) {
+            memcpy(snapshot->shadow + stripe * SNAPSHOT_STRIPE, snapshot->base + stripe * SNAPSHOT_STRIPE, SNAPSHOT_STRIPE);
+            atomic_store(tag, done);
+            return;
+        }
+    }
+}
+
+void preserve(snapshot_t* snapshot, commit_t* commit, const void* address, size_t size) {
+    if (!commit->preserving || size == 0) return;
+    size_t offset = (const char*) address - snapshot->base;
+    size_t first = offset / SNAPSHOT_STRIPE;
+    size_t last = (offset + size - 1) / SNAPSHOT_STRIPE;
+    // Stripes past the shadow were allocated after ts, they are not in the snapshot
+    size_t end = snapshot->shadow_size / SNAPSHOT_STRIPE;
+    for (size_t stripe = first; stripe <= last && stripe < end; stripe++) {
+        capture(snapshot, commit->epoch, stripe);
+    }
+}
+
+void leave_commit(snapshot_t* snapshot, commit_t* commit) {
+    if (commit->counted) {
+        atomic_fetch_sub(&(snapshot->committing[commit->phase]), 1);
+        commit->counted = false;
+    }
+    if (commit->preserving) {
+        atomic_fetch_sub(&(snapshot->preserving), 1);
+        commit->preserving = false;
+    }
+}
+
+// Capture [offset, offset + size) and hand it to the sink from the shadow copy
+static bool emit(snapshot_t* snapshot, uint64_t epoch, size_t offset, size_t size, tm_sink_t sink, void* context) {
+    while (size > 0) {
+        size_t first = offset / SNAPSHOT_STRIPE;
+        size_t length = (first + SNAPSHOT_BATCH) * SNAPSHOT_STRIPE - offset;
+        if (length > size) length = size;
+        size_t last = (offset + length - 1) / SNAPSHOT_STRIPE;
+        for (size_t stripe = first; stripe <= last; stripe++) {
+            capture(snapshot, epoch, stripe);
+        }
+        if (!sink(context, snapshot->shadow + offset, length)) return false;
+        offset += length;
+        size -= length;
+    }
+    return true;
+}
+
+static bool emit_segment(snapshot_t* snapshot, uint64_t epoch, size_t offset, size_t size, tm_sink_t sink, void* context) {
+    tm_snapshot_segment_t header = {offset, size};
+    return sink(context, &header, sizeof(header)) && emit(snapshot, epoch, offset, size, sink, context);
+}
+
+bool take_snapshot(region_t* region, tm_sink_t sink, void* context) {
+    snapshot_t* snapshot = &(region->snapshot);
+    pthread_mutex_lock(&(snapshot->mutex));
+    uint64_t epoch = CONTROL_EPOCH(atomic_load(&(snapshot->control))) + 1;
+
+    // Fix ts, then drain the committers that may have a version <= ts
+    atomic_store(&(snapshot->control), CONTROL(SNAPSHOT_PENDING, epoch, 0));
+    uint_t ts = fetch_global_counter(region->counter);
+    atomic_store(&(snapshot->control), CONTROL(SNAPSHOT_DRAINING, epoch, ts));
+    unsigned int phase = atomic_load(&(snapshot->phase));
+    atomic_store(&(snapshot->phase), phase ^ 1);
+    while (atomic_load(&(snapshot->committing[phase])) != 0) {
+        snapshot_pause();
+    }
+
+    // Every segment committed at ts lies below the current heap top
+    size_t heap_offset = region->heap.start - snapshot->base;
+    size_t extent = heap_offset + get_heap_top(&(region->heap));
+    memory_t shadow;
+    bool res = alloc_memory(&shadow, round_up(extent, SNAPSHOT_STRIPE), SNAPSHOT_STRIPE, MEMORY_PAGES);
+    if (res) {
+        snapshot->shadow = (char*) shadow.start;
+        snapshot->shadow_size = round_up(extent, SNAPSHOT_STRIPE);
+        atomic_store(&(snapshot->control), CONTROL(SNAPSHOT_ACTIVE, epoch, ts));
+
+        // First segment, then the live heap segments in address order
+        res = emit_segment(snapshot, epoch, 0, region->size, sink, context);
+        size_t offset = heap_offset;
+        while (res && offset < extent) {
+            size_t segment = offset + region->heap.header_size;
+            block_header_t header;
+            for (size_t stripe = offset / SNAPSHOT_STRIPE; stripe <= (segment - 1) / SNAPSHOT_STRIPE; stripe++) {
+                capture(snapshot, epoch, stripe);
+            }
+            memcpy(&header, snapshot->shadow + offset, sizeof(header));
+            if (header.live) {
+                res = emit_segment(snapshot, epoch, segment, header.size, sink, context);
+            }
+            offset = segment + header.size;
+        }
+    }
+
+    // Wait for the writers still copying into the shadow before dropping it
+    atomic_store(&(snapshot->control), CONTROL(SNAPSHOT_IDLE, epoch, ts));
+    while (atomic_load(&(snapshot->preserving)) != 0) {
+        snapshot_pause();
+    }
+    if (snapshot->shadow) {
+        free_memory(&shadow);
+        snapshot->shadow = NULL;
+        snapshot->shadow_size = 0;
+    }
+    pthread_mutex_unlock(&(snapshot->mutex));
+    return res;
+}
@@ -0,0 +1,62 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+#include "own_types.h"
+#include "tm_ext.h"
+
+// Online point-in-time snapshot (tm_snapshot) of the first segment and the
+// live heap segments, taken while writers keep committing.
+//
+// Taking a snapshot at timestamp ts:
+//   1. publish "pending", sample ts from the global clock, publish "draining";
+//   2. flip the commit phase and wait for the committers of the old phase,
+//      which include every writer with wv <= ts, to finish writing back;
+//   3. publish "active" and stream the segments, stripe by stripe.
+// A writer with wv > ts that commits while the snapshot is active first
+// preserves the pre-image of each stripe it is about to write into a shadow
+// copy (copy-on-write). Stripes carry the epoch k of the snapshot that last
+// captured them: 2k when captured, 2k + 1 while being captured. The streaming
+// thread captures the stripes no writer preserved and reads everything back
+// from the shadow copy, so the stream is exactly the state at ts.
+#define SNAPSHOT_STRIPE 4096
+
+typedef struct snapshot {
+    _Atomic uint64_t control;          // Packed state, epoch and ts
+    atomic_uint phase;                 // Current commit phase
+    atomic_int committing[2];          // Committers per phase
+    atomic_int preserving;             // Writers copying stripes
+    _Atomic uint64_t* stripes;         // Capture tag per stripe
+    memory_t stripes_memory;
+    char* base;                        // Start of the covered range
+    size_t size;                       // Size of the covered range
+    char* shadow;                      // Captured stripes (while active)
+    size_t shadow_size;
+    pthread_mutex_t mutex;             // One snapshot at a time
+} snapshot_t;
+
+// Commit-side state of a writer, from before it takes its write version to
+// after its write-back
+typedef struct commit {
+    unsigned int phase;
+    bool counted;      // Counted in committing[phase]
+    bool preserving;   // Counted in preserving, must preserve its stripes
+    uint64_t epoch;
+} commit_t;
+
+struct region;
+
+bool init_snapshot(snapshot_t* snapshot, void* base, size_t size);
+void fini_snapshot(snapshot_t* snapshot);
+void enter_commit(snapshot_t* snapshot, commit_t* commit);
+void prepare_write_back(snapshot_t* snapshot, commit_t* commit, uint_t wv);
+void preserve(snapshot_t* snapshot, commit_t* commit, const void* address, size_t size);
+void leave_commit(snapshot_t* snapshot, commit_t* commit);
+bool take_snapshot(struct region* region, tm_sink_t sink, void* context);
+
+#endif /* SNAPSHOT_H */
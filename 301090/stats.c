@@ -0,0 +1,165 @@
+#include "stats.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static atomic_uint_fast64_t next_stats_id = 1;
+
+// Block of the last region used by the thread
+static _Thread_local struct {
+    uint64_t id;
+    thread_stats_t* block;
+} thread_cache = {0, NULL};
+static _Thread_local char thread_token;
+
+bool init_stats(stats_t* stats) {
+    if (pthread_mutex_init(&(stats->lock), NULL) != 0) return false;
+    stats->id = atomic_fetch_add(&next_stats_id, 1);
+    stats->first = NULL;
+    return true;
+}
+
+void fini_stats(stats_t* stats) {
+    thread_stats_t* block = stats->first;
+    while (block) {
+        thread_stats_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    stats->first = NULL;
+    pthread_mutex_destroy(&(stats->lock));
+}
+
+thread_stats_t* get_thread_stats(stats_t* stats) {
+    if (thread_cache.id == stats->id) return thread_cache.block;
+    pthread_mutex_lock(&(stats->lock));
+    thread_stats_t* block = stats->first;
+    while (block && block->owner != &thread_token) block = block->next;
+    if (!block) {
+        block = (thread_stats_t*) aligned_alloc(_Alignof(thread_stats_t), sizeof(thread_stats_t));
+        if (block) {
+            memset(block, 0, sizeof(thread_stats_t));
+            block->owner = &thread_token;
+            block->next = stats->first;
+            stats->first = block;
+        }
+    }
+    pthread_mutex_unlock(&(stats->lock));
+    if (!block) return NULL;
+    thread_cache.id = stats->id;
+    thread_cache.block = block;
+    return block;
+}
+
+size_t get_size_bucket(size_t size) {
+    size_t bucket = 0;
+    while (size > 0 && bucket < STATS_BUCKETS - 1) {
+        size >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+#ifdef USE_PHASES
+static size_t get_cycle_bucket(uint64_t cycles) {
+    size_t bucket = cycles > 0 ? 64 - __builtin_clzll(cycles) : 0;
+    return bucket < PHASE_BUCKETS ? bucket : PHASE_BUCKETS - 1;
+}
+
+void record_phases(thread_stats_t* stats, const uint64_t* phases) {
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        if (phases[i] == 0) continue;
+        stats->phases[i] += phases[i];
+        stats->phase_histograms[i][get_cycle_bucket(phases[i])]++;
+    }
+}
+
+void record_wasted(thread_stats_t* stats, uint64_t cycles) {
+    stats->wasted += cycles;
+    stats->wasted_histogram[get_cycle_bucket(cycles)]++;
+}
+#endif
+
+// snprintf appending at *length, counting what does not fit
+static void append(char* buffer, size_t size, size_t* length, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(*length < size ? buffer + *length : NULL, *length < size ? size - *length : 0, format, args);
+    va_end(args);
+    if (written > 0) *length += written;
+}
+
+static void append_array(char* buffer, size_t size, size_t* length, const char* name, const uint64_t* values, size_t count) {
+    append(buffer, size, length, "\"%s\":[", name);
+    for (size_t i = 0; i < count; i++) {
+        append(buffer, size, length, "%s%llu", i > 0 ? "," : "", (unsigned long long) values[i]);
+    }
+    append(buffer, size, length, "]");
+}
+
+size_t format_stats(stats_t* stats, char* buffer, size_t size) {
+    // Sum the blocks (racy with the running threads, but each counter is exact once they are done)
+    thread_stats_t total;
+    memset(&total, 0, sizeof(total));
+    size_t threads = 0;
+    pthread_mutex_lock(&(stats->lock));
+    for (thread_stats_t* block = stats->first; block; block = block->next) {
+        total.begins += block->begins;
+        total.commits += block->commits;
+        for (size_t i = 0; i < STATS_REASONS; i++) total.aborts[i] += block->aborts[i];
+        for (size_t i = 0; i < STATS_BUCKETS; i++) {
+            total.read_sets[i] += block->read_sets[i];
+            total.write_sets[i] += block->write_sets[i];
+        }
+        total.validations += block->validations;
+        total.commit_validations += block->commit_validations;
+        total.lock_retries += block->lock_retries;
+#ifdef USE_PHASES
+        for (size_t i = 0; i < PHASE_COUNT; i++) {
+            total.phases[i] += block->phases[i];
+            for (size_t j = 0; j < PHASE_BUCKETS; j++) total.phase_histograms[i][j] += block->phase_histograms[i][j];
+        }
+        total.wasted += block->wasted;
+        for (size_t j = 0; j < PHASE_BUCKETS; j++) total.wasted_histogram[j] += block->wasted_histogram[j];
+#endif
+        threads++;
+    }
+    pthread_mutex_unlock(&(stats->lock));
+
+    static const char* const reasons[STATS_REASONS] = {"none", "read_locked", "read_version", "commit_locked", "commit_validation", "nomem", "invalid"};
+    size_t length = 0;
+    if (size > 0) buffer[0] = '\0';
+    append(buffer, size, &length, "{\"threads\":%zu,\"begins\":%llu,\"commits\":%llu,\"aborts\":{", threads, (unsigned long long) total.begins, (unsigned long long) total.commits);
+    for (size_t i = 1; i < STATS_REASONS; i++) {
+        append(buffer, size, &length, "%s\"%s\":%llu", i > 1 ? "," : "", reasons[i], (unsigned long long) total.aborts[i]);
+    }
+    append(buffer, size, &length, "},");
+    append_array(buffer, size, &length, "read_set_log2_histogram", total.read_sets, STATS_BUCKETS);
+    append(buffer, size, &length, ",");
+    append_array(buffer, size, &length, "write_set_log2_histogram", total.write_sets, STATS_BUCKETS);
+    append(buffer, size, &length, ",\"validations\":%llu,\"commit_validations\":%llu,\"lock_retries\":%llu", (unsigned long long) total.validations, (unsigned long long) total.commit_validations, (unsigned long long) total.lock_retries);
+#ifdef USE_PHASES
+    static const char* const phases[PHASE_COUNT] = {"begin", "read", "post_validation", "write", "lock", "validation", "write_back", "release"};
+    append(buffer, size, &length, ",\"phases\":{");
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        append(buffer, size, &length, "%s\"%s\":{\"cycles\":%llu,", i > 0 ? "," : "", phases[i], (unsigned long long) total.phases[i]);
+        append_array(buffer, size, &length, "log2_histogram", total.phase_histograms[i], PHASE_BUCKETS);
+        append(buffer, size, &length, "}");
+    }
+    append(buffer, size, &length, ",\"aborted\":{\"cycles\":%llu,", (unsigned long long) total.wasted);
+    append_array(buffer, size, &length, "log2_histogram", total.wasted_histogram, PHASE_BUCKETS);
+    append(buffer, size, &length, "}}");
+#endif
+    append(buffer, size, &length, "}");
+    return length;
+}
+
+void dump_stats(stats_t* stats) {
+    if (!getenv("TM_STATS")) return;
+    char buffer[16384];
+    size_t length = format_stats(stats, buffer, sizeof(buffer));
+    fprintf(stderr, "%s\n", length < sizeof(buffer) ? buffer : "{}");
+}
@@ -0,0 +1,89 @@
+#ifndef STATS_H
+#define STATS_H
+
+// Compile-time configuration (or 'make STATS=1' / 'make PHASES=1', which
+// rebuild every object whenever the flags differ from the last build)
+// #define USE_STATS
+// #define USE_PHASES
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-thread event counters of a region, kept only when built with USE_STATS:
+// otherwise every STATS(...) update compiles to nothing. Each thread counts in
+// its own cache-line aligned block, summed when read (tm_stats_json) and
+// printed as JSON on stderr by tm_destroy if TM_STATS is set.
+#if defined(USE_PHASES) && !defined(USE_STATS)
+    #define USE_STATS
+#endif
+#ifdef USE_STATS
+    #define STATS(statement) statement
+#else
+    #define STATS(statement)
+#endif
+
+// Phase accounting (USE_PHASES, implies USE_STATS): each transaction adds the
+// TSC cycles spent in each of its phases, folded into the counters of its
+// thread when it commits; an aborted attempt counts as a whole, from its begin
+// to its abort. The calls into the TM count, the code between them does not.
+#ifdef USE_PHASES
+    #define PHASES(statement) statement
+#else
+    #define PHASES(statement)
+#endif
+
+typedef enum phase {
+    PHASE_BEGIN,            // Descriptor and version-clock sampling
+    PHASE_READ,             // Reads, with the write set probe and pre-validation
+    PHASE_POST_VALIDATION,  // Post-validation of the reads
+    PHASE_WRITE,            // Buffering of the writes
+    PHASE_LOCK,             // Lock acquisition at commit
+    PHASE_VALIDATION,       // Clock increment and read set validation at commit
+    PHASE_WRITE_BACK,       // Logging, snapshot preservation and write-back
+    PHASE_RELEASE,          // Lock release, durability wait and freeing
+    PHASE_COUNT
+} phase_t;
+
+#define STATS_REASONS 7  // Abort reasons (tm_abort_t)
+#define STATS_BUCKETS 16 // Set size histogram buckets: 0, then [2^(i-1), 2^i), the last one unbounded
+#define PHASE_BUCKETS 32 // Cycle histogram buckets, as above
+
+typedef struct thread_stats {
+    uint64_t begins;
+    uint64_t commits;
+    uint64_t aborts[STATS_REASONS];
+    uint64_t read_sets[STATS_BUCKETS];  // Read set sizes of the committed read-write transactions
+    uint64_t write_sets[STATS_BUCKETS]; // Write set sizes of the committed read-write transactions
+    uint64_t validations;               // Range checks of the reads (pre and post)
+    uint64_t commit_validations;        // Read set validations at commit
+    uint64_t lock_retries;              // Failed lock acquisitions at commit
+#ifdef USE_PHASES
+    uint64_t phases[PHASE_COUNT];                       // Cycles of the committed transactions
+    uint64_t phase_histograms[PHASE_COUNT][PHASE_BUCKETS]; // Per transaction, of the phases it went through
+    uint64_t wasted;                                    // Cycles of the aborted attempts
+    uint64_t wasted_histogram[PHASE_BUCKETS];
+#endif
+    struct thread_stats* next;
+    const void* owner;
+} __attribute__((aligned(64))) thread_stats_t;
+
+typedef struct stats {
+    pthread_mutex_t lock;
+    uint64_t id;            // Distinguishes the regions in the thread caches
+    thread_stats_t* first;
+} stats_t;
+
+bool init_stats(stats_t* stats);
+void fini_stats(stats_t* stats);
+thread_stats_t* get_thread_stats(stats_t* stats);
+size_t get_size_bucket(size_t size);
+#ifdef USE_PHASES
+void record_phases(thread_stats_t* stats, const uint64_t* phases);
+void record_wasted(thread_stats_t* stats, uint64_t cycles);
+#endif
+size_t format_stats(stats_t* stats, char* buffer, size_t size);
+void dump_stats(stats_t* stats);
+
+#endif /* STATS_H */
@@ -2,7 +2,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 
-#include "tm.h"
+#include <tm.h>
 #include <pthread.h>
 #include <unistd.h>
 
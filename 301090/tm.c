@@ -22,7 +22,8 @@
 #endif
 
 // Internal headers
-#include "tm.h"
+#include <tm.h>
+#include <tm_ext.h>
 
 #include <stdio.h>
 #include <errno.h>
@@ -32,6 +33,7 @@
 #include "versioned_lock.h"
 #include "transaction.h"
 #include "list.h"
+#include "numa.h"
 
 // -------------------------------------------------------------------------- //
 
@@ -83,6 +85,32 @@ static inline void pause() {
 #endif
 }
 
+#define BACKOFF_MIN 16      // Spins of the first backoff
+#define BACKOFF_MAX 16384   // Spins of the longest backoff
+#define BACKOFF_YIELD 8     // Consecutive aborts before also yielding the CPU
+
+/** Wait before the next attempt of a transaction, for a random number of
+ * spins in a window doubling with each consecutive abort.
+ * @param aborts Consecutive aborts so far
+**/
+static void backoff(size_t aborts) {
+    static _Thread_local uint64_t state = 0;
+    if (unlikely(state == 0)) state = (uintptr_t) &state | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    size_t window = BACKOFF_MIN;
+    for (size_t i = 1; i < aborts && window < BACKOFF_MAX; i++) window *= 2;
+    for (size_t spins = (state * UINT64_C(0x2545f4914f6cdd1d)) % window; spins > 0; spins--) {
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+        __builtin_ia32_pause();
+#else
+        atomic_signal_fence(memory_order_seq_cst);
+#endif
+    }
+    if (aborts >= BACKOFF_YIELD) pause();
+}
+
 // -------------------------------------------------------------------------- //
 
 shared_t tm_create(size_t size, size_t align) {
@@ -92,53 +120,117 @@ shared_t tm_create(size_t size, size_t align) {
       return invalid_shared;
   }
 
-  // Allocate shared memory
+  // Allocate shared memory: the first segment, then the heap of tm_alloc
   if (align % sizeof(void*) != 0) {
       align = sizeof(void*);
   }
-  if (posix_memalign(&(region->start), align, size) != 0) {
-      free(region);
-      return invalid_shared;
+  size_t page_size = get_page_size();
+  size_t first_size = (size + page_size - 1) / page_size * page_size;
+  size_t heap_size = get_heap_size() / align * align;
+  size_t total_size = first_size + heap_size;
+  memory_mode_t memory_mode = get_memory_mode();
+  const char* durable_path = get_durable_path();
+  region->wal = NULL;
+  if (durable_path) {
+      // Durable region: recover the data file from the redo log, then map it
+      region->wal = open_wal(durable_path, size, get_durability());
+      if (!region->wal) {
+          free(region);
+          return invalid_shared;
+      }
+      heap_size = 0; // No tm_alloc on durable regions
+      total_size = first_size;
+      if (!alloc_file_memory(&(region->memory), region->wal->data_fd, size, heap_size)) {
+          close_wal(region->wal);
+          free(region);
+          return invalid_shared;
+      }
+  } else if (!alloc_lazy_memory(&(region->memory), total_size, align, memory_mode)) {
+      // No lazy mapping: the heap would be committed and zeroed eagerly, size it from the first segment
+      heap_size = get_fallback_heap_size(first_size) / align * align;
+      total_size = first_size + heap_size;
+      if (!alloc_memory(&(region->memory), total_size, align, MEMORY_HEAP)) {
+          free(region);
+          return invalid_shared;
+      }
   }
+  region->start = region->memory.start;
 
   // Init counter
   region->counter = create_global_counter();
   if (!region->counter) {
-      free(region->start);
+      free_memory(&(region->memory));
+      close_wal(region->wal);
       free(region);
       return invalid_shared;
   }
 
-  // Init locks
-  size_t locks_array_size = size / align;
-  //printf("Locks array size = %zu\n", locks_array_size);
-  region->locks = (versioned_lock_t**) malloc(locks_array_size * sizeof(versioned_lock_t*));
-  if (!region->locks) {
+  // Init locks (zero-filled, i.e. unlocked at version 0), covering the heap too;
+  // only committed eagerly along with an eagerly committed (hence smaller) heap
+  size_t locks_array_size = total_size / align;
+  size_t locks_size = locks_array_size * sizeof(versioned_lock_t);
+  bool locks_ok = region->memory.mode == MEMORY_HEAP
+      ? alloc_memory(&(region->locks_memory), locks_size, sizeof(versioned_lock_t), memory_mode)
+      : alloc_lazy_memory(&(region->locks_memory), locks_size, sizeof(versioned_lock_t), memory_mode);
+  if (!locks_ok) {
       destroy_global_counter(region->counter);
-      free(region->start);
+      free_memory(&(region->memory));
+      close_wal(region->wal);
       free(region);
       return invalid_shared;
   }
+  region->locks = (versioned_lock_t*) region->locks_memory.start;
 
-  for (size_t i = 0; i < locks_array_size; i++) {
-      (region->locks)[i] = create_versioned_lock();
-      if (!(region->locks)[i]) {
-          for (size_t j = 0; j < i; j++) {
-              destroy_versioned_lock((region->locks)[j]);
-          }
-          destroy_global_counter(region->counter);
-          free(region->start);
-          free(region);
-          return invalid_shared;
-      }
+  // Init heap and snapshot support
+  if (!init_heap(&(region->heap), (char*) region->start + first_size, heap_size, align)) {
+      free_memory(&(region->locks_memory));
+      destroy_global_counter(region->counter);
+      free_memory(&(region->memory));
+      close_wal(region->wal);
+      free(region);
+      return invalid_shared;
+  }
+  if (!init_snapshot(&(region->snapshot), region->start, total_size)) {
+      fini_heap(&(region->heap));
+      free_memory(&(region->locks_memory));
+      destroy_global_counter(region->counter);
+      free_memory(&(region->memory));
+      close_wal(region->wal);
+      free(region);
+      return invalid_shared;
+  }
+  region->sites = create_sites();
+  if (!region->sites || !init_stats(&(region->stats))) {
+      destroy_sites(region->sites);
+      fini_snapshot(&(region->snapshot));
+      fini_heap(&(region->heap));
+      free_memory(&(region->locks_memory));
+      destroy_global_counter(region->counter);
+      free_memory(&(region->memory));
+      close_wal(region->wal);
+      free(region);
+      return invalid_shared;
+  }
+  if (!init_heatmap(&(region->heatmap))) {
+      fini_stats(&(region->stats));
+      destroy_sites(region->sites);
+      fini_snapshot(&(region->snapshot));
+      fini_heap(&(region->heap));
+      free_memory(&(region->locks_memory));
+      destroy_global_counter(region->counter);
+      free_memory(&(region->memory));
+      close_wal(region->wal);
+      free(region);
+      return invalid_shared;
   }
 
-  // for (size_t i = 0; i < locks_array_size; i++) {
-  //     print_versioned_lock((region->locks)[i]);
-  // }
+  init_tracing();
 
-  // Init shared_memory with 0
-  memset(region->start, 0, size);
+  // Place shared memory and locks over the NUMA nodes (nothing is touched yet,
+  // and lock i covers word i, so both ranges are partitioned alike)
+  numa_policy_t numa_policy = get_numa_policy();
+  place_memory(region->memory.map_start, region->memory.map_size, region->memory.page_size, numa_policy);
+  place_memory(region->locks_memory.map_start, region->locks_memory.map_size, region->locks_memory.page_size, numa_policy);
 
   // Finish initialization and return region
   atomic_init(&(region->tx_id), 0);
@@ -151,10 +243,26 @@ shared_t tm_create(size_t size, size_t align) {
 void tm_destroy(shared_t shared) {
     region_t* region = (region_t*) shared;
     if (region) {
+        STATS(dump_stats(&(region->stats)));
+        if (!write_heatmap(&(region->heatmap), region->start, region->align, &(region->heap))) {
+            fprintf(stderr, "tm: cannot write the conflict heatmap to '%s'\n", region->heatmap.path);
+        }
+        fini_heatmap(&(region->heatmap));
+        if (!write_trace()) {
+            fprintf(stderr, "tm: cannot write the event trace\n");
+        }
+        fini_stats(&(region->stats));
+        destroy_sites(region->sites);
+        fini_snapshot(&(region->snapshot));
+        fini_heap(&(region->heap));
         if (region->start) {
-            free(region->start);
+            free_memory(&(region->memory));
             region->start = NULL;
         }
+        // Flush and checkpoint the redo log
+        if (region->wal) {
+            close_wal(region->wal);
+        }
         // Destroy counter
         if (region->counter) {
             destroy_global_counter(region->counter);
@@ -162,11 +270,7 @@ void tm_destroy(shared_t shared) {
 
         // Destroy locks
         if (region->locks) {
-            size_t locks_array_size = tm_size(shared) / tm_align(shared);
-            for (size_t i = 0; i < locks_array_size; i++) {
-                destroy_versioned_lock((region->locks)[i]);
-            }
-            free(region->locks);
+            free_memory(&(region->locks_memory));
         }
         free(region);
     }
@@ -194,124 +298,348 @@ tx_t tm_begin(shared_t shared, bool is_ro) {
 
     // Sample global version-clock
     transaction->rv = fetch_global_counter(region->counter);
+    PHASES(end_phase(transaction, PHASE_BEGIN));
     return (tx_t) transaction;
 }
 
-bool tm_end(shared_t shared, tx_t tx) {
+tx_t tm_begin_hinted(shared_t shared, bool is_ro, tm_hints_t const* hints) {
     region_t* region = (region_t*) shared;
-    transaction_t* transaction = (transaction_t*) tx;
+    transaction_t* transaction = create_transaction(region, is_ro);
+    if (!transaction) return invalid_tx;
 
-    //printf("Size of READ_SET = %d\n", transaction->read_set->size);
-    //printf("Size of WRITE_SET = %d\n", transaction->write_set->size);
-    if (!transaction->is_read_only) {
-        // Lock write_set
-        list_t* acquired_locks = create_list();
-        list_t* write_set = transaction->write_set;
-        node_t* write_node = write_set->first;
-        while (write_node) {
-            store_t* store = (store_t*) write_node->content;
-            int start_index = get_locks_start_index(region, store->address_to_be_written);
-            int end_index = get_locks_end_index(region, store->address_to_be_written, store->size);
-
-            for (int i = start_index; i < end_index; i++) {
-                bool acquired = acquire_versioned_lock((region->locks)[i], transaction->tx_id);
-                if (acquired) {
-                    //printf("TRY TO ACQUIRE\n");
-                    //printf("LOCK ID = %d\n", i);
-                    //print_versioned_lock((region->locks)[i]);
-                    node_t* lock_node = create_node((region->locks)[i]);
-                    add_node(acquired_locks, lock_node);
-                } else {
-                    // Release every acquired lock and abort
-                    node_t* node_to_release = acquired_locks->first;
-                    while (node_to_release) {
-                        versioned_lock_t* lock_to_release = (versioned_lock_t*) node_to_release->content;
-                        release_versioned_lock_untouched(lock_to_release, transaction->tx_id);
-                        node_to_release = node_to_release->next;
-                    }
-                    return false;
-                }
+    if (hints) {
+        transaction->site = get_site(region->sites, hints->site);
+        transaction->priority = hints->priority > 0 ? hints->priority : 0;
+        // Read-only transactions keep no logs, the others get theirs up front,
+        // sized like the largest committed one of their site by default
+        if (!is_ro) {
+            size_t reads = hints->reads;
+            size_t writes = hints->writes;
+            if (transaction->site && reads == 0 && writes == 0) {
+                reads = atomic_load_explicit(&(transaction->site->reads), memory_order_relaxed);
+                writes = atomic_load_explicit(&(transaction->site->writes), memory_order_relaxed);
             }
-            write_node = write_node->next;
+            if (!reserve_logs(transaction, reads, writes)) return invalid_tx;
         }
+    }
 
-        // Increment global version-clock
-        transaction->wv = increment_and_fetch_global_counter(region->counter);
-
-        // Validate read_set
-        if (transaction->rv + 1 != transaction->wv) {
-            list_t* read_set = transaction->read_set;
-            node_t* read_node = read_set->first;
-            while (read_node) {
-                load_t* load = (load_t*) read_node->content;
-                int start_index = get_locks_start_index(region, load->read_address);
-                int end_index = get_locks_end_index(region, load->read_address, load->size);
-
-                for (int i = start_index; i < end_index; i++) {
-                    // If lock.version > rv OR locked by another tx ==> abort
-                    versioned_lock_t* lock_to_validate = (region->locks)[i];
-                    if (get_versioned_lock_version(lock_to_validate) > transaction->rv || (get_versioned_lock_tx_id(lock_to_validate) != transaction->tx_id && get_versioned_lock_tx_id(lock_to_validate) != 0)) {
-                        // Release every acquired lock and abort
-                        node_t* node_to_release = acquired_locks->first;
-                        while (node_to_release) {
-                            versioned_lock_t* lock_to_release = (versioned_lock_t*) node_to_release->content;
-                            release_versioned_lock_untouched(lock_to_release, transaction->tx_id);
-                            node_to_release = node_to_release->next;
-                        }
-                        return false;
-                    }
+    // Sample global version-clock
+    transaction->rv = fetch_global_counter(region->counter);
+    PHASES(end_phase(transaction, PHASE_BEGIN));
+    return (tx_t) transaction;
+}
+
+bool tm_get_site_stats(shared_t shared, uint32_t id, tm_site_stats_t* stats) {
+    site_t* site = get_site(((region_t*) shared)->sites, id);
+    if (!site) return false;
+    stats->commits = atomic_load_explicit(&(site->commits), memory_order_relaxed);
+    stats->aborts = atomic_load_explicit(&(site->aborts), memory_order_relaxed);
+    stats->reads = atomic_load_explicit(&(site->reads), memory_order_relaxed);
+    stats->writes = atomic_load_explicit(&(site->writes), memory_order_relaxed);
+    return true;
+}
+
+// Diagnostics of the last aborted transaction of the thread
+static _Thread_local tm_abort_info_t last_abort = {0, NULL, 0, 0};
+
+bool tm_last_abort(tm_abort_info_t* info) {
+    *info = last_abort;
+    return last_abort.reason != none_abort;
+}
+
+// Record why the transaction aborts, with the stripe of the given lock if any;
+// returns false for the caller to return
+static bool set_abort(region_t* region, transaction_t* transaction, tm_abort_t reason, versioned_lock_t* lock) {
+    tm_abort_info_t* abort = &(transaction->abort);
+    abort->reason = reason;
+    abort->address = NULL;
+    abort->stripe = 0;
+    abort->owner = 0;
+    if (lock) {
+        abort->stripe = lock - region->locks;
+        abort->address = (char*) region->start + abort->stripe * region->align;
+        abort->owner = atomic_load_explicit(&(lock->tx_id), memory_order_relaxed);
+    }
+    return false;
+}
+
+// Give back the segments allocated by an aborted transaction
+static void abort_transaction(region_t* region, transaction_t* transaction) {
+    // Failures with no reason recorded come from the allocation of the logs
+    if (transaction->abort.reason == none_abort) set_abort(region, transaction, nomem_abort, NULL);
+    last_abort = transaction->abort;
+    if (unlikely(region->heatmap.table) && transaction->abort.address) {
+        tm_abort_t reason = transaction->abort.reason;
+        record_conflict(&(region->heatmap), transaction->abort.stripe, reason == commit_locked_abort || reason == commit_validation_abort);
+    }
+    STATS(transaction->stats->aborts[transaction->abort.reason]++);
+    PHASES(record_wasted(transaction->stats, read_tsc() - transaction->phase_start));
+    if (transaction->site) record_abort(transaction->site);
+    trace(TRACE_ABORT, transaction->tx_id, transaction->abort.reason);
+    if (!transaction->allocated) return;
+    node_t* node = transaction->allocated->first;
+    while (node) {
+        release_block(&(region->heap), node->content);
+        node = node->next;
+    }
+}
+
+static void release_locks_untouched(list_t* acquired_locks, uint_t tx_id) {
+    node_t* node_to_release = acquired_locks->first;
+    while (node_to_release) {
+        versioned_lock_t* lock_to_release = (versioned_lock_t*) node_to_release->content;
+        release_versioned_lock_untouched(lock_to_release, tx_id);
+        node_to_release = node_to_release->next;
+    }
+}
+
+static bool lock_range(region_t* region, transaction_t* transaction, list_t* acquired_locks, const void* address, size_t size) {
+    size_t start_index = get_locks_start_index(region, address);
+    size_t end_index = get_locks_end_index(region, address, size);
+
+    for (size_t i = start_index; i < end_index; i++) {
+        versioned_lock_t* lock = &((region->locks)[i]);
+        if (get_versioned_lock_tx_id(lock) == transaction->tx_id) continue;
+        // A transaction with priority p insists p more times on a busy lock
+        for (int retries = transaction->priority; !acquire_versioned_lock(lock, transaction->tx_id); retries--) {
+            STATS(transaction->stats->lock_retries++);
+            if (retries == 0) return set_abort(region, transaction, commit_locked_abort, lock);
+            pause();
+        }
+        node_t* lock_node = new_node(transaction, lock);
+        if (!lock_node) {
+            release_versioned_lock_untouched(lock, transaction->tx_id);
+            return false;
+        }
+        add_node(acquired_locks, lock_node);
+    }
+    return true;
+}
+
+static bool commit_transaction(region_t* region, transaction_t* transaction) {
+    heap_t* heap = &(region->heap);
+    snapshot_t* snapshot = &(region->snapshot);
+
+    // Lock write_set, plus the headers of the allocated segments and the
+    // freed segments as a whole (concurrent readers of them must abort)
+    trace(TRACE_LOCK, transaction->tx_id, 0);
+    PHASES(begin_phase(transaction));
+    list_t* acquired_locks = new_list(transaction);
+    if (!acquired_locks) return false;
+    list_t* write_set = transaction->write_set;
+    node_t* write_node = write_set->first;
+    while (write_node) {
+        store_t* store = (store_t*) write_node->content;
+        if (!lock_range(region, transaction, acquired_locks, store->address_to_be_written, store->size)) {
+            // Release every acquired lock and abort
+            release_locks_untouched(acquired_locks, transaction->tx_id);
+            return false;
+        }
+        write_node = write_node->next;
+    }
+    for (node_t* node = transaction->allocated->first; node; node = node->next) {
+        if (!lock_range(region, transaction, acquired_locks, get_block_header(heap, node->content), heap->header_size)) {
+            release_locks_untouched(acquired_locks, transaction->tx_id);
+            return false;
+        }
+    }
+    for (node_t* node = transaction->freed->first; node; node = node->next) {
+        block_header_t* header = get_block_header(heap, node->content);
+        if (!lock_range(region, transaction, acquired_locks, header, heap->header_size + header->size)) {
+            release_locks_untouched(acquired_locks, transaction->tx_id);
+            return false;
+        }
+    }
+
+    trace(TRACE_LOCKED, transaction->tx_id, acquired_locks->size < UINT16_MAX ? acquired_locks->size : UINT16_MAX);
+    PHASES(end_phase(transaction, PHASE_LOCK));
+
+    // Increment global version-clock, announced to a concurrent snapshot
+    commit_t commit;
+    enter_commit(snapshot, &commit);
+    transaction->wv = increment_and_fetch_global_counter(region->counter);
+
+    // Validate read_set
+    if (transaction->rv + 1 != transaction->wv) {
+        STATS(transaction->stats->commit_validations++);
+        list_t* read_set = transaction->read_set;
+        node_t* read_node = read_set->first;
+        while (read_node) {
+            load_t* load = (load_t*) read_node->content;
+            size_t start_index = get_locks_start_index(region, load->read_address);
+            size_t end_index = get_locks_end_index(region, load->read_address, load->size);
+
+            for (size_t i = start_index; i < end_index; i++) {
+                // If lock.version > rv OR locked by another tx ==> abort
+                versioned_lock_t* lock_to_validate = &((region->locks)[i]);
+                if (get_versioned_lock_version(lock_to_validate) > transaction->rv || (get_versioned_lock_tx_id(lock_to_validate) != transaction->tx_id && get_versioned_lock_tx_id(lock_to_validate) != 0)) {
+                    // Release every acquired lock and abort
+                    set_abort(region, transaction, commit_validation_abort, lock_to_validate);
+                    leave_commit(snapshot, &commit);
+                    release_locks_untouched(acquired_locks, transaction->tx_id);
+                    return false;
                 }
-                read_node = read_node->next;
             }
+            read_node = read_node->next;
         }
+    }
+    PHASES(end_phase(transaction, PHASE_VALIDATION));
+
+    // Log the write set while its locks are held, so that the log order
+    // agrees with the conflict order
+    uint64_t lsn = 0;
+    if (region->wal && write_set->first) {
+        lsn = append_wal(region->wal, write_set, region->start);
+    }
 
-        // Commit and release the locks
-        write_node = write_set->last;
-        while (write_node) {
+    // Copy what is about to change aside if a snapshot older than wv is active
+    prepare_write_back(snapshot, &commit, transaction->wv);
+    if (commit.preserving) {
+        for (write_node = write_set->first; write_node; write_node = write_node->next) {
             store_t* store = (store_t*) write_node->content;
-            // Write value
-            memcpy(store->address_to_be_written, store->value_to_be_written, store->size);
-            write_node = write_node->previous;
+            preserve(snapshot, &commit, store->address_to_be_written, store->size);
+        }
+        for (node_t* node = transaction->allocated->first; node; node = node->next) {
+            preserve(snapshot, &commit, get_block_header(heap, node->content), heap->header_size);
         }
-        // Release locks
-        node_t* node_to_release = acquired_locks->first;
-        while (node_to_release) {
-            versioned_lock_t* lock_to_release = (versioned_lock_t*) node_to_release->content;
-            release_versioned_lock(lock_to_release, transaction->tx_id, transaction->wv);
-            node_to_release = node_to_release->next;
+        for (node_t* node = transaction->freed->first; node; node = node->next) {
+            block_header_t* header = get_block_header(heap, node->content);
+            preserve(snapshot, &commit, header, heap->header_size + header->size);
         }
     }
+
+    // Commit and release the locks
+    write_node = write_set->last;
+    while (write_node) {
+        store_t* store = (store_t*) write_node->content;
+        // Write value
+        memcpy(store->address_to_be_written, store->value_to_be_written, store->size);
+        write_node = write_node->previous;
+    }
+    for (node_t* node = transaction->allocated->first; node; node = node->next) {
+        get_block_header(heap, node->content)->live = 1;
+    }
+    for (node_t* node = transaction->freed->first; node; node = node->next) {
+        get_block_header(heap, node->content)->live = 0;
+    }
+    PHASES(end_phase(transaction, PHASE_WRITE_BACK));
+
+    // Release locks
+    node_t* node_to_release = acquired_locks->first;
+    while (node_to_release) {
+        versioned_lock_t* lock_to_release = (versioned_lock_t*) node_to_release->content;
+        release_versioned_lock(lock_to_release, transaction->tx_id, transaction->wv);
+        node_to_release = node_to_release->next;
+    }
+    leave_commit(snapshot, &commit);
+
+    // Return once the record is durable (batched with concurrent committers)
+    if (lsn > 0) {
+        wait_wal(region->wal, lsn);
+    }
+
+    // Freed segments can only be reused once the free is committed
+    for (node_t* node = transaction->freed->first; node; node = node->next) {
+        release_block(heap, node->content);
+    }
+    PHASES(end_phase(transaction, PHASE_RELEASE));
     return true;
 }
 
-bool tm_read_post_validation(region_t* region, transaction_t* transaction, const void* address, size_t size) {
-    // Post validation
-    int start_index = get_locks_start_index(region, address);
-    int end_index = get_locks_end_index(region, address, size);
-
-    //printf("start_index: %d\n", start_index);
-    //printf("end_index: %d\n", end_index);
+bool tm_end(shared_t shared, tx_t tx) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
 
-    for (int i = start_index; i < end_index; i++) {
-        versioned_lock_t* lock_to_validate = (region->locks)[i];
-        //printf("POST VALIDATION\n");
-        //printf("lock_version? %d\n", get_versioned_lock_version(lock_to_validate));
-        //printf("rv? %d\n", transaction->rv);
-        //printf("lock tx_id? %d\n", get_versioned_lock_tx_id(lock_to_validate));
+    //printf("Size of READ_SET = %d\n", transaction->read_set->size);
+    //printf("Size of WRITE_SET = %d\n", transaction->write_set->size);
+    if (transaction->is_read_only) {
+        if (transaction->site) record_commit(transaction->site, 0, 0);
+        STATS(transaction->stats->commits++);
+        PHASES(record_phases(transaction->stats, transaction->phases));
+        trace(TRACE_COMMIT, transaction->tx_id, 0);
+        return true;
+    }
+    if (commit_transaction(region, transaction)) {
+        STATS(transaction->stats->commits++);
+        PHASES(record_phases(transaction->stats, transaction->phases));
+        trace(TRACE_COMMIT, transaction->tx_id, 0);
+        STATS(transaction->stats->read_sets[get_size_bucket(transaction->read_set->size)]++);
+        STATS(transaction->stats->write_sets[get_size_bucket(transaction->write_set->size)]++);
+        if (transaction->site) record_commit(transaction->site, transaction->read_set->size, transaction->write_set->size);
+        return true;
+    }
+    abort_transaction(region, transaction);
+    return false;
+}
 
-        //print_versioned_lock(lock_to_validate);
-        if (get_versioned_lock_version(lock_to_validate) > transaction->rv || get_versioned_lock_tx_id(lock_to_validate) != 0) {
-            return false;
+// Check that no lock covering the range is held nor newer than rv; the lock
+// array is scanned directly, so a range costs one pass over its lock words
+static bool check_range_locks(region_t* region, transaction_t* transaction, const void* address, size_t size) {
+    versioned_lock_t* lock = region->locks + get_locks_start_index(region, address);
+    versioned_lock_t* end = region->locks + get_locks_end_index(region, address, size);
+    STATS(transaction->stats->validations++);
+    for (; lock < end; lock++) {
+        // Lock state first: once seen released, the version of its holder is visible
+        if (atomic_load_explicit(&(lock->tx_id), memory_order_acquire) != 0) {
+            trace(TRACE_READ_FAIL, transaction->tx_id, read_locked_abort);
+            return set_abort(region, transaction, read_locked_abort, lock);
+        }
+        if (lock->version > transaction->rv) {
+            trace(TRACE_READ_FAIL, transaction->tx_id, read_version_abort);
+            return set_abort(region, transaction, read_version_abort, lock);
         }
     }
     return true;
 }
 
+bool tm_read_pre_validation(region_t* region, transaction_t* transaction, const void* address, size_t size) {
+    // Pre validation: a writer holding one of the locks may be writing back,
+    // and a writer locking after this point commits with a version > rv,
+    // which the post validation catches
+    return check_range_locks(region, transaction, address, size);
+}
+
+bool tm_read_post_validation(region_t* region, transaction_t* transaction, const void* address, size_t size) {
+    PHASES(end_phase(transaction, PHASE_READ));
 
-// TODO : if fails, call tm_end
-bool tm_read(shared_t shared as(unused), tx_t tx as(unused), void const* source, size_t size, void* target) {
-    region_t* region = (region_t*) shared;
-    transaction_t* transaction = (transaction_t*) tx;
+    // Keep the copy before the post validation loads
+    atomic_thread_fence(memory_order_acquire);
+
+    // Post validation
+    bool valid = check_range_locks(region, transaction, address, size);
+    PHASES(end_phase(transaction, PHASE_POST_VALIDATION));
+    return valid;
+}
+
+static bool read_range(region_t* region, transaction_t* transaction, void const* source, size_t size, void* target) {
+    if (!tm_read_pre_validation(region, transaction, source, size)) return false;
+    memcpy(target, source, size);
+    if (!transaction->is_read_only) {
+        // One entry for the whole range
+        load_t* load = new_load(transaction, size);
+        if (!load) return false;
+        load->read_address = source;
+        node_t* load_node = new_node(transaction, load);
+        if (!load_node) return false;
+        add_node(transaction->read_set, load_node);
+
+        // Overlay the overlapping writes of the transaction, oldest first
+        const char* begin = (const char*) source;
+        const char* end = begin + size;
+        for (node_t* node = transaction->write_set->last; node; node = node->previous) {
+            store_t* store = (store_t*) node->content;
+            const char* store_begin = (const char*) store->address_to_be_written;
+            const char* store_end = store_begin + store->size;
+            if (store_end <= begin || store_begin >= end) continue;
+            const char* from = store_begin > begin ? store_begin : begin;
+            const char* to = store_end < end ? store_end : end;
+            memcpy((char*) target + (from - begin), (const char*) store->value_to_be_written + (from - store_begin), to - from);
+        }
+    }
+    return tm_read_post_validation(region, transaction, source, size);
+}
+
+static bool read_value(region_t* region, transaction_t* transaction, void const* source, size_t size, void* target) {
     // Check if load read_address already appears in the write_set
     if (!transaction->is_read_only) {
         // No write_set to check if transaction is read-only
@@ -321,57 +649,320 @@ bool tm_read(shared_t shared as(unused), tx_t tx as(unused), void const* source,
             node_t* node = write_set->first;
             while (node) {
                 store_t* store = (store_t*) node->content;
-                if (store->address_to_be_written == source) {
+                const char* store_begin = (const char*) store->address_to_be_written;
+                if (store_begin == source && store->size == size) {
                     // Return value found
                     // Reads the value and store in read_set
-                    load_t* load = new_load(size);
+                    load_t* load = new_load(transaction, size);
                     if (!load) return false;
                     load->read_address = source;
-                    node_t* new_node = create_node(load);
-                    if (!new_node) return false;
-                    add_node(transaction->read_set, new_node);
+                    node_t* load_node = new_node(transaction, load);
+                    if (!load_node) return false;
+                    add_node(transaction->read_set, load_node);
                     memcpy(target, store->value_to_be_written, size);
                     return tm_read_post_validation(region, transaction, source, size);
                 }
+                if (store_begin < (const char*) source + size && (const char*) source < store_begin + store->size) {
+                    // Partly written (e.g. by a range write): merge the writes
+                    return read_range(region, transaction, source, size, target);
+                }
                 node = node->next;
             }
         //}
-        load_t* load = new_load(size);
+        load_t* load = new_load(transaction, size);
         if (!load) return false;
         load->read_address = source;
-        node_t* new_node = create_node(load);
-        if (!new_node) return false;
-        add_node(transaction->read_set, new_node);
+        node_t* load_node = new_node(transaction, load);
+        if (!load_node) return false;
+        add_node(transaction->read_set, load_node);
+        if (!tm_read_pre_validation(region, transaction, source, size)) return false;
         memcpy(target, source, size);
         return tm_read_post_validation(region, transaction, source, size);
     }
+    if (!tm_read_pre_validation(region, transaction, source, size)) return false;
     memcpy(target, source, size);
     return tm_read_post_validation(region, transaction, source, size);
 }
 
-// TODO : if fails, call tm_end
-bool tm_write(shared_t shared as(unused), tx_t tx as(unused), void const* source, size_t size, void* target) {
-    transaction_t* transaction = (transaction_t*) tx;
+static bool write_value(transaction_t* transaction, void const* source, size_t size, void* target) {
 
-    store_t* store = new_store(size);
+    store_t* store = new_store(transaction, size);
     if (!store) return false;
     store->address_to_be_written = target;
     memcpy(store->value_to_be_written, source, size);
 
     //bloom_add(transaction->write_set_bloom_filter, &(store->address_to_be_written), sizeof(void*));
 
-    node_t* new_node = create_node(store);
-    if (!new_node) return false;
-    add_node(transaction->write_set, new_node);
+    node_t* store_node = new_node(transaction, store);
+    if (!store_node) return false;
+    add_node(transaction->write_set, store_node);
+    return true;
+}
+
+bool tm_read(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    PHASES(begin_phase(transaction));
+    if (read_value(region, transaction, source, size, target)) {
+        PHASES(end_phase(transaction, PHASE_READ));
+        return true;
+    }
+    abort_transaction(region, transaction);
+    return false;
+}
+
+bool tm_write(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    PHASES(begin_phase(transaction));
+    if (write_value(transaction, source, size, target)) {
+        PHASES(end_phase(transaction, PHASE_WRITE));
+        return true;
+    }
+    abort_transaction(region, transaction);
+    return false;
+}
+
+bool tm_read_range(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    PHASES(begin_phase(transaction));
+    if (read_range(region, transaction, source, size, target)) {
+        PHASES(end_phase(transaction, PHASE_READ));
+        return true;
+    }
+    abort_transaction(region, transaction);
+    return false;
+}
+
+bool tm_write_range(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
+    // A store already holds a whole range, written back with a single copy
+    return tm_write(shared, tx, source, size, target);
+}
+
+static bool read_vector(region_t* region, transaction_t* transaction, const tm_vec_t* vecs, size_t count) {
+    // Elements the transaction may have written go through the single read path
+    if (!transaction->is_read_only && transaction->write_set->first) {
+        for (size_t i = 0; i < count; i++) {
+            if (!read_value(region, transaction, vecs[i].shared, vecs[i].size, vecs[i].local)) return false;
+        }
+        return true;
+    }
+
+    // Overlap the cache misses of every element, then one pre-validation,
+    // copy and post-validation pass over all of them
+    for (size_t i = 0; i < count; i++) {
+        __builtin_prefetch(region->locks + get_locks_start_index(region, vecs[i].shared));
+        __builtin_prefetch(vecs[i].shared);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!tm_read_pre_validation(region, transaction, vecs[i].shared, vecs[i].size)) return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        memcpy(vecs[i].local, vecs[i].shared, vecs[i].size);
+    }
+    PHASES(end_phase(transaction, PHASE_READ));
+    atomic_thread_fence(memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        if (!check_range_locks(region, transaction, vecs[i].shared, vecs[i].size)) return false;
+    }
+    PHASES(end_phase(transaction, PHASE_POST_VALIDATION));
+    if (!transaction->is_read_only) {
+        for (size_t i = 0; i < count; i++) {
+            load_t* load = new_load(transaction, vecs[i].size);
+            if (!load) return false;
+            load->read_address = vecs[i].shared;
+            node_t* load_node = new_node(transaction, load);
+            if (!load_node) return false;
+            add_node(transaction->read_set, load_node);
+        }
+    }
+    return true;
+}
+
+bool tm_readv(shared_t shared, tx_t tx, tm_vec_t const* vecs, size_t count) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    PHASES(begin_phase(transaction));
+    if (read_vector(region, transaction, vecs, count)) {
+        PHASES(end_phase(transaction, PHASE_READ));
+        return true;
+    }
+    abort_transaction(region, transaction);
+    return false;
+}
+
+bool tm_writev(shared_t shared, tx_t tx, tm_vec_t const* vecs, size_t count) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    PHASES(begin_phase(transaction));
+    for (size_t i = 0; i < count; i++) {
+        if (!write_value(transaction, vecs[i].local, vecs[i].size, vecs[i].shared)) {
+            abort_transaction(region, transaction);
+            return false;
+        }
+    }
+    PHASES(end_phase(transaction, PHASE_WRITE));
+    return true;
+}
+
+bool tm_release(shared_t shared as(unused), tx_t tx, void const* address, size_t size) {
+    transaction_t* transaction = (transaction_t*) tx;
+    // Read-only transactions have no read set: each read is validated on its own
+    if (transaction->is_read_only) return true;
+
+    // Forget the reads lying within the range, they are not validated at commit
+    const char* begin = (const char*) address;
+    const char* end = begin + size;
+    node_t* node = transaction->read_set->first;
+    while (node) {
+        node_t* next = node->next;
+        load_t* load = (load_t*) node->content;
+        const char* load_begin = (const char*) load->read_address;
+        if (load_begin >= begin && load_begin + load->size <= end) {
+            remove_node(transaction->read_set, node);
+        }
+        node = next;
+    }
+    return true;
+}
+
+alloc_t tm_alloc(shared_t shared, tx_t tx, size_t size, void** target) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    if (transaction->is_read_only) {
+        set_abort(region, transaction, invalid_abort, NULL);
+        abort_transaction(region, transaction);
+        return abort_alloc;
+    }
+
+    // Durable regions only persist the first segment: an allocated segment would be lost at restart
+    if (region->wal) return nomem_alloc;
+
+    // Segment allocated right away, published by the commit (header made live)
+    void* segment = alloc_block(&(region->heap), size, region->align);
+    if (!segment) return nomem_alloc;
+    node_t* node = new_node(transaction, segment);
+    if (!node) {
+        release_block(&(region->heap), segment);
+        abort_transaction(region, transaction);
+        return abort_alloc;
+    }
+    add_node(transaction->allocated, node);
+    *target = segment;
+    return success_alloc;
+}
+
+bool tm_free(shared_t shared, tx_t tx, void* segment) {
+    region_t* region = (region_t*) shared;
+    transaction_t* transaction = (transaction_t*) tx;
+    // The first segment cannot be freed (nor anything in a durable region, which cannot allocate)
+    if (transaction->is_read_only || region->wal || !is_heap_block(&(region->heap), segment)) {
+        set_abort(region, transaction, invalid_abort, NULL);
+        abort_transaction(region, transaction);
+        return false;
+    }
+    node_t* node = new_node(transaction, segment);
+    if (!node) {
+        abort_transaction(region, transaction);
+        return false;
+    }
+    add_node(transaction->freed, node);
     return true;
 }
 
-// TODO : if fails, call tm_end
-alloc_t tm_alloc(shared_t shared, tx_t tx as(unused), size_t size, void** target) {
-  return abort_alloc;
+bool tm_set_tracing(bool enabled) {
+    return set_tracing(enabled);
+}
+
+size_t tm_stats_json(shared_t shared as(unused), char* buffer as(unused), size_t size as(unused)) {
+#ifdef USE_STATS
+    return format_stats(&(((region_t*) shared)->stats), buffer, size);
+#else
+    return 0;
+#endif
+}
+
+bool tm_snapshot(shared_t shared, tm_sink_t sink, void* context) {
+    return take_snapshot((region_t*) shared, sink, context);
+}
+
+bool tm_run(shared_t shared, bool is_ro, tm_body_t body, void* context, size_t* attempts) {
+    size_t aborts = 0;
+    while (true) {
+        tx_t tx = tm_begin(shared, is_ro);
+        if (unlikely(tx == invalid_tx)) return false;
+        // The attempt is already aborted if the body returns false
+        if (likely(body(shared, tx, context) && tm_end(shared, tx))) break;
+        backoff(++aborts);
+    }
+    if (attempts) *attempts = aborts + 1;
+    return true;
+}
+
+typedef uint64_t (*rmw_op_t)(uint64_t, uint64_t, uint64_t);
+
+static uint64_t op_fetch_add(uint64_t current, uint64_t delta, uint64_t unused as(unused)) {
+    return current + delta;
+}
+
+static uint64_t op_compare_swap(uint64_t current, uint64_t expected, uint64_t desired) {
+    return current == expected ? desired : current;
+}
+
+static uint64_t op_swap(uint64_t current as(unused), uint64_t value, uint64_t unused as(unused)) {
+    return value;
+}
+
+// One-word transaction: lock the word, then read, update and release it with
+// a fresh version, as the commit of a transaction with this single store
+static uint64_t read_modify_write(region_t* region, void* address, rmw_op_t op, uint64_t a, uint64_t b) {
+    versioned_lock_t* lock = region->locks + get_locks_start_index(region, address);
+    uint_t tx_id = increment_and_fetch_tx_id(region);
+    while (!acquire_versioned_lock(lock, tx_id)) {
+        pause();
+    }
+    uint64_t previous;
+    memcpy(&previous, address, sizeof(previous));
+    uint64_t value = op(previous, a, b);
+    if (value == previous) {
+        // Nothing to write (e.g. failed compare): linearized while locked
+        release_versioned_lock_untouched(lock, tx_id);
+        return previous;
+    }
+
+    commit_t commit;
+    enter_commit(&(region->snapshot), &commit);
+    uint_t wv = increment_and_fetch_global_counter(region->counter);
+    uint64_t lsn = 0;
+    if (region->wal) {
+        store_t store = {address, &value, sizeof(value)};
+        node_t node;
+        list_t write_set;
+        init_node(&node, &store);
+        init_list(&write_set);
+        add_node(&write_set, &node);
+        lsn = append_wal(region->wal, &write_set, region->start);
+    }
+    prepare_write_back(&(region->snapshot), &commit, wv);
+    preserve(&(region->snapshot), &commit, address, sizeof(value));
+    memcpy(address, &value, sizeof(value));
+    release_versioned_lock(lock, tx_id, wv);
+    leave_commit(&(region->snapshot), &commit);
+    if (lsn > 0) {
+        wait_wal(region->wal, lsn);
+    }
+    return previous;
+}
+
+uint64_t tm_fetch_add(shared_t shared, void* address, uint64_t delta) {
+    return read_modify_write((region_t*) shared, address, op_fetch_add, delta, 0);
+}
+
+uint64_t tm_compare_swap(shared_t shared, void* address, uint64_t expected, uint64_t desired) {
+    return read_modify_write((region_t*) shared, address, op_compare_swap, expected, desired);
 }
 
-// TODO : if fails, call tm_end
-bool tm_free(shared_t shared, tx_t tx as(unused), void* segment) {
-  return false;
+uint64_t tm_swap(shared_t shared, void* address, uint64_t value) {
+    return read_modify_write((region_t*) shared, address, op_swap, value, 0);
 }
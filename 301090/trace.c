@@ -0,0 +1,147 @@
+#define _GNU_SOURCE
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tsc.h"
+
+typedef struct trace_buffer {
+    struct trace_buffer* next;
+    uint32_t thread;
+    atomic_bool done;           // Thread exited, freed once written
+    _Atomic uint64_t head;      // Events recorded (only written by its thread)
+    uint64_t dropped;           // Events already written or dropped (only accessed under trace_lock)
+    trace_event_t events[TRACE_CAPACITY];
+} trace_buffer_t;
+
+atomic_bool tracing = false;
+
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+static pthread_key_t trace_key;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static trace_buffer_t* buffers = NULL;
+static uint32_t next_thread = 0;
+static char* trace_path = NULL; // Set once, by init_trace_path
+static uint64_t start_tsc;      // Calibration of the TSC
+static uint64_t start_ns;
+
+static uint64_t read_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static void release_buffer(void* buffer) {
+    atomic_store(&(((trace_buffer_t*) buffer)->done), true);
+}
+
+static void init_trace_key() {
+    pthread_key_create(&trace_key, release_buffer);
+}
+
+static void init_trace_path() {
+    const char* path = getenv("TM_TRACE");
+    if (!path || !*path) return;
+    trace_path = strdup(path);
+    start_tsc = read_tsc();
+    start_ns = read_ns();
+    atomic_store(&tracing, trace_path != NULL);
+}
+
+// Read TM_TRACE and calibrate the TSC on the first call only, so that later
+// regions neither switch tracing back on nor shift the calibration
+void init_tracing() {
+    pthread_once(&init_once, init_trace_path);
+}
+
+bool set_tracing(bool enabled) {
+    init_tracing();
+    if (enabled && !trace_path) return false; // Nowhere to write the events
+    return atomic_exchange(&tracing, enabled);
+}
+
+static trace_buffer_t* get_thread_buffer() {
+    static _Thread_local trace_buffer_t* buffer = NULL;
+    if (buffer) return buffer;
+    pthread_once(&trace_once, init_trace_key);
+    buffer = (trace_buffer_t*) malloc(sizeof(trace_buffer_t));
+    if (!buffer) return NULL;
+    atomic_init(&(buffer->head), 0);
+    buffer->dropped = 0;
+    atomic_init(&(buffer->done), false);
+    pthread_mutex_lock(&trace_lock);
+    buffer->thread = next_thread++;
+    buffer->next = buffers;
+    buffers = buffer;
+    pthread_mutex_unlock(&trace_lock);
+    pthread_setspecific(trace_key, buffer);
+    return buffer;
+}
+
+void record_event(trace_type_t type, uint32_t tx, uint16_t detail) {
+    trace_buffer_t* buffer = get_thread_buffer();
+    if (!buffer) return;
+    uint64_t head = atomic_load_explicit(&(buffer->head), memory_order_relaxed);
+    trace_event_t* event = &(buffer->events[head & (TRACE_CAPACITY - 1)]);
+    event->tsc = read_tsc();
+    event->tx = tx;
+    event->type = type;
+    event->detail = detail;
+    atomic_store_explicit(&(buffer->head), head + 1, memory_order_release);
+}
+
+// Write the events recorded by every thread since the previous call (the last
+// TRACE_CAPACITY of each at most) and drop them
+bool write_trace() {
+    pthread_mutex_lock(&trace_lock);
+    if (!trace_path) {
+        pthread_mutex_unlock(&trace_lock);
+        return true;
+    }
+    bool res = false;
+    FILE* file = fopen(trace_path, "wb");
+    if (file) {
+        uint64_t tsc = read_tsc() - start_tsc;
+        uint64_t ns = read_ns() - start_ns;
+        double ticks_per_us = ns > 0 ? (double) tsc * 1000. / (double) ns : 1.;
+        uint32_t count = 0;
+        for (trace_buffer_t* buffer = buffers; buffer; buffer = buffer->next) count++;
+        uint32_t zero = 0;
+        res = fwrite("TMTRACE1", 8, 1, file) == 1 && fwrite(&ticks_per_us, sizeof(ticks_per_us), 1, file) == 1
+           && fwrite(&count, sizeof(count), 1, file) == 1 && fwrite(&zero, sizeof(zero), 1, file) == 1;
+        for (trace_buffer_t* buffer = buffers; buffer && res; buffer = buffer->next) {
+            uint64_t head = atomic_load_explicit(&(buffer->head), memory_order_acquire);
+            uint64_t recorded = head - buffer->dropped;
+            uint32_t size = recorded < TRACE_CAPACITY ? (uint32_t) recorded : TRACE_CAPACITY;
+            uint64_t lost = recorded - size;
+            res = fwrite(&(buffer->thread), sizeof(uint32_t), 1, file) == 1 && fwrite(&size, sizeof(size), 1, file) == 1
+               && fwrite(&lost, sizeof(lost), 1, file) == 1;
+            // Oldest first: from the oldest kept event up to the end of the ring, then from its start
+            uint32_t first = (uint32_t) ((head - size) & (TRACE_CAPACITY - 1));
+            uint32_t tail = TRACE_CAPACITY - first < size ? TRACE_CAPACITY - first : size;
+            if (res && tail > 0) res = fwrite(buffer->events + first, sizeof(trace_event_t), tail, file) == tail;
+            if (res && size > tail) res = fwrite(buffer->events, sizeof(trace_event_t), size - tail, file) == size - tail;
+            buffer->dropped = head;
+        }
+        res = fclose(file) == 0 && res;
+    }
+    // Drop the buffers of the exited threads (the events written are dropped by moving the marks, the heads being
+    // only written by their threads)
+    trace_buffer_t** link = &buffers;
+    while (*link) {
+        trace_buffer_t* buffer = *link;
+        if (atomic_load(&(buffer->done))) {
+            *link = buffer->next;
+            free(buffer);
+        } else {
+            link = &(buffer->next);
+        }
+    }
+    pthread_mutex_unlock(&trace_lock);
+    return res;
+}
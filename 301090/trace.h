@@ -0,0 +1,50 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Event tracing: each thread records 16-byte events in its own ring buffer of
+// TRACE_CAPACITY events (the oldest ones are overwritten), stamped with the
+// TSC. Tracing is on from the first tm_create if TM_TRACE names a file, and
+// switched with tm_set_tracing (never on without TM_TRACE); while off, an event
+// costs one relaxed load and branch. The events are written to the file at
+// tm_destroy (rewritten by each region destroyed, with the events recorded
+// since the previous one), then discarded.
+// Threads may keep tracing meanwhile on other regions: a full ring being
+// overwritten while written can only tear its oldest events.
+//
+// File: "TMTRACE1", double TSC ticks per microsecond, uint32 number of threads,
+// uint32 0, then for each thread: uint32 thread index, uint32 number of events,
+// uint64 number of overwritten events, and the events (oldest first).
+#define TRACE_CAPACITY (1u << 16)
+
+typedef enum trace_type {
+    TRACE_BEGIN = 1,  // detail: whether read-only
+    TRACE_READ_FAIL,  // detail: abort reason (tm_abort_t)
+    TRACE_LOCK,       // Commit starts acquiring its locks
+    TRACE_LOCKED,     // Commit holds its locks, detail: number of locks (saturated)
+    TRACE_COMMIT,
+    TRACE_ABORT       // detail: abort reason (tm_abort_t)
+} trace_type_t;
+
+typedef struct trace_event {
+    uint64_t tsc;
+    uint32_t tx;      // Transaction ID
+    uint16_t type;
+    uint16_t detail;
+} trace_event_t;
+
+extern atomic_bool tracing;
+
+void init_tracing();
+bool set_tracing(bool enabled);
+bool write_trace();
+void record_event(trace_type_t type, uint32_t tx, uint16_t detail);
+
+static inline void trace(trace_type_t type, uint32_t tx, uint16_t detail) {
+    if (__builtin_expect(atomic_load_explicit(&tracing, memory_order_relaxed), 0)) record_event(type, tx, detail);
+}
+
+#endif /* TRACE_H */
@@ -1,88 +1,95 @@
 #include "transaction.h"
 
-void destroy_read_node(node_t* node) {
-    load_t* content = (load_t*) node->content;
-    free(content);
-    node->content = NULL;
-    free(node);
-}
-
-void destroy_write_node(node_t* node) {
-    store_t* content = (store_t*) node->content;
-    free(content->value_to_be_written);
-    content->value_to_be_written = NULL;
-    free(content);
-    node->content = NULL;
-    free(node);
-}
+#include <stdalign.h>
+#include <stddef.h>
+#include <string.h>
 
 transaction_t* create_transaction(region_t* region, bool is_read_only) {
-    transaction_t* transaction = (transaction_t*) malloc(sizeof(transaction_t));
+    PHASES(uint64_t start = read_tsc());
+
+    // Recycle the logs of the previous transaction of this thread
+    arena_t* arena = get_thread_arena();
+    if (!arena) return NULL;
+    reset_arena(arena);
+
+    transaction_t* transaction = (transaction_t*) arena_alloc(arena, sizeof(transaction_t));
     if (!transaction) return NULL;
+    transaction->arena = arena;
     transaction->is_read_only = is_read_only;
 
     // Init transaction id
     transaction->tx_id = increment_and_fetch_tx_id(region);
 
+    transaction->read_set = NULL;
+    transaction->write_set = NULL;
+    transaction->allocated = NULL;
+    transaction->freed = NULL;
     if (!is_read_only) {
-        // Init read-set and write-set
-        transaction->read_set = create_list();
-        if (!transaction->read_set) {
-            free(transaction);
-            return NULL;
-        }
+        // Init read-set, write-set and allocation logs
+        transaction->read_set = new_list(transaction);
+        if (!transaction->read_set) return NULL;
+
+        transaction->write_set = new_list(transaction);
+        if (!transaction->write_set) return NULL;
+
+        transaction->allocated = new_list(transaction);
+        if (!transaction->allocated) return NULL;
 
-        transaction->write_set = create_list();
-        if (!transaction->write_set) {
-            destroy_list(transaction->read_set, destroy_read_node);
-            free(transaction);
-            return NULL;
-        }
-        // transaction->write_set_bloom_filter = (struct bloom*) malloc(sizeof(struct bloom));
-        // if (!transaction->write_set_bloom_filter) {
-        //     destroy_list(transaction->write_set);
-        //     destroy_list(transaction->read_set);
-        //     free(transaction);
-        //     return NULL;
-        // }
-        // if (bloom_init(transaction->write_set_bloom_filter, 10000, 0.01) != 0) {
-        //     //free(transaction->write_set_bloom_filter);
-        //     destroy_list(transaction->write_set);
-        //     destroy_list(transaction->read_set);
-        //     free(transaction);
-        //     return NULL;
-        // }
+        transaction->freed = new_list(transaction);
+        if (!transaction->freed) return NULL;
     }
+    transaction->site = NULL;
+    transaction->priority = 0;
+    transaction->abort.reason = none_abort;
+#ifdef USE_STATS
+    transaction->stats = get_thread_stats(&(region->stats));
+    if (!transaction->stats) return NULL;
+    transaction->stats->begins++;
+#endif
+#ifdef USE_PHASES
+    transaction->phase_start = start;
+    transaction->phase_mark = start;
+    memset(transaction->phases, 0, sizeof(transaction->phases));
+#endif
     transaction->rv = 0;
     transaction->wv = 0;
+    trace(TRACE_BEGIN, transaction->tx_id, is_read_only);
     return transaction;
 }
 
-void destroy_transaction(transaction_t* transaction) {
-    if (!transaction) return;
-    if (transaction->read_set) {
-        destroy_list(transaction->read_set, destroy_read_node);
-        free(transaction->read_set);
-    }
-    if (transaction->write_set) {
-        destroy_list(transaction->read_set, destroy_write_node);
-        free(transaction->write_set);
-    }
-    // if (transaction->write_set_bloom_filter) {
-    //     bloom_free(transaction->write_set_bloom_filter);
-    //     free(transaction->write_set_bloom_filter);
-    // }
+list_t* new_list(transaction_t* transaction) {
+    list_t* list = (list_t*) arena_alloc(transaction->arena, sizeof(list_t));
+    if (!list) return NULL;
+    init_list(list);
+    return list;
+}
+
+node_t* new_node(transaction_t* transaction, void* content) {
+    node_t* node = (node_t*) arena_alloc(transaction->arena, sizeof(node_t));
+    if (!node) return NULL;
+    init_node(node, content);
+    return node;
 }
 
-load_t* new_load(size_t size) {
-    load_t* load = (load_t*) malloc(sizeof(load_t));
+load_t* new_load(transaction_t* transaction, size_t size) {
+    load_t* load = (load_t*) arena_alloc(transaction->arena, sizeof(load_t));
+    if (!load) return NULL;
     load->size = size;
     return load;
 }
 
-store_t* new_store(size_t size) {
-    store_t* store = (store_t*) malloc(sizeof(store_t));
-    store->value_to_be_written = malloc(size);
+store_t* new_store(transaction_t* transaction, size_t size) {
+    store_t* store = (store_t*) arena_alloc(transaction->arena, sizeof(store_t));
+    if (!store) return NULL;
+    store->value_to_be_written = arena_alloc(transaction->arena, size);
+    if (!store->value_to_be_written) return NULL;
     store->size = size;
     return store;
 }
+
+bool reserve_logs(transaction_t* transaction, size_t reads, size_t writes) {
+    // Entries with word-sized values (larger ones get more room on demand)
+    size_t read_entry = sizeof(load_t) + sizeof(node_t) + 2 * alignof(max_align_t);
+    size_t write_entry = sizeof(store_t) + sizeof(node_t) + sizeof(void*) + 3 * alignof(max_align_t);
+    return reserve_arena(transaction->arena, reads * read_entry + writes * write_entry);
+}
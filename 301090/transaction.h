@@ -6,14 +6,34 @@
 #include "own_types.h"
 #include "region.h"
 #include "list.h"
+#include "arena.h"
+#include "tm_ext.h"
+#include "trace.h"
+#include "tsc.h"
 
+// The descriptor and everything hanging from it live in the arena of the
+// calling thread, which is recycled by the next create_transaction.
 typedef struct transaction {
+    arena_t* arena;
     uint_t tx_id;
     bool is_read_only;
     uint_t rv;
     uint_t wv;
     list_t* read_set;
     list_t* write_set;
+    list_t* allocated;       // Segments from tm_alloc, released on abort
+    list_t* freed;           // Segments from tm_free, released on commit
+    site_t* site;            // Site of the transaction (hinted only)
+    int priority;            // Persistence on busy locks at commit (hinted only)
+    tm_abort_info_t abort;   // Why the transaction is aborting (nomem_abort if unset)
+#ifdef USE_STATS
+    thread_stats_t* stats;   // Counters of the calling thread
+#endif
+#ifdef USE_PHASES
+    uint64_t phase_start;    // TSC at the begin
+    uint64_t phase_mark;     // TSC at the start of the current phase
+    uint64_t phases[PHASE_COUNT];
+#endif
     //struct bloom* write_set_bloom_filter;
 } transaction_t;
 
@@ -29,8 +49,24 @@ typedef struct store {
 } store_t;
 
 transaction_t* create_transaction(region_t* region, bool is_read_only);
-void destroy_transaction(transaction_t* transaction);
-load_t* new_load(size_t size);
-store_t* new_store(size_t size);
+list_t* new_list(transaction_t* transaction);
+node_t* new_node(transaction_t* transaction, void* content);
+load_t* new_load(transaction_t* transaction, size_t size);
+store_t* new_store(transaction_t* transaction, size_t size);
+bool reserve_logs(transaction_t* transaction, size_t reads, size_t writes);
+
+#ifdef USE_PHASES
+static inline void begin_phase(transaction_t* transaction) {
+    transaction->phase_mark = read_tsc();
+}
+
+// Charge the cycles since the start of the current phase to the given one,
+// which starts the next phase
+static inline void end_phase(transaction_t* transaction, phase_t phase) {
+    uint64_t now = read_tsc();
+    transaction->phases[phase] += now - transaction->phase_mark;
+    transaction->phase_mark = now;
+}
+#endif
 
 #endif /* TRANSACTION_H */
@@ -0,0 +1,21 @@
+#ifndef TSC_H
+#define TSC_H
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+    #include <x86intrin.h>
+#endif
+
+// Time stamp counter (reference cycles), nanoseconds where there is none
+static inline uint64_t read_tsc() {
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+#endif /* TSC_H */
@@ -1,18 +1,6 @@
 #include "versioned_lock.h"
 #include <stdio.h>
 
-versioned_lock_t* create_versioned_lock() {
-    versioned_lock_t* lock = (versioned_lock_t*) malloc(sizeof(versioned_lock_t));
-    if (!lock) return NULL;
-    atomic_init(&(lock->tx_id), 0);
-    lock->version = 0;
-    return lock;
-}
-
-void destroy_versioned_lock(versioned_lock_t* lock) {
-    free(lock);
-}
-
 uint_t get_versioned_lock_tx_id(versioned_lock_t* lock) {
     return lock->tx_id;
 }
@@ -6,13 +6,13 @@
 #include <stdbool.h>
 #include "own_types.h"
 
+// A zero-filled lock is unlocked at version 0, so lock tables allocated from
+// zero-filled memory need no initialization pass.
 typedef struct versioned_lock {
   atomic_uint tx_id;
   uint_t version;
 } versioned_lock_t;
 
-versioned_lock_t* create_versioned_lock();
-void destroy_versioned_lock(versioned_lock_t* lock);
 uint_t get_versioned_lock_tx_id(versioned_lock_t* lock);
 uint_t get_versioned_lock_version(versioned_lock_t* lock);
 bool acquire_versioned_lock(versioned_lock_t* lock, uint_t tx_id);
@@ -0,0 +1,338 @@
+#define _GNU_SOURCE
+#include "wal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "transaction.h"
+
+#define WAL_MAGIC 0x4c41573230393031ul        // Record header marker
+#define WAL_CHECKPOINT_SIZE (64ul << 20)      // Log size triggering a checkpoint
+#define WAL_READ_SIZE (1ul << 20)             // Read granularity of the log replay
+#define WAL_DEFAULT_INTERVAL_MS 10
+
+// Record layout: header, then for each store (in program order) an entry
+// header followed by the value, padded to 8 bytes
+typedef struct wal_header {
+    uint64_t magic;
+    uint64_t length;    // Bytes following the header
+    uint64_t checksum;  // Checksum of those bytes
+} wal_header_t;
+
+typedef struct wal_entry {
+    uint64_t offset;    // Offset of the target in the region
+    uint64_t size;
+} wal_entry_t;
+
+static size_t pad(size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+static uint64_t checksum(const char* data, size_t size) {
+    // FNV-1a, only meant to detect a torn last record
+    uint64_t hash = 0xcbf29ce484222325ul;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (unsigned char) data[i]) * 0x100000001b3ul;
+    }
+    return hash;
+}
+
+static void fail(const char* what) {
+    // A commit cannot be undone once its writes are visible: losing the log is fatal
+    fprintf(stderr, "tm: durable region %s failed: %s\n", what, strerror(errno));
+    abort();
+}
+
+static void write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t res = write(fd, data, size);
+        if (res < 0) {
+            if (errno == EINTR) continue;
+            fail("log write");
+        }
+        data += res;
+        size -= (size_t) res;
+    }
+}
+
+static bool reserve(wal_buffer_t* buffer, size_t size) {
+    if (buffer->size + size <= buffer->capacity) return true;
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->size + size) capacity *= 2;
+    char* data = (char*) realloc(buffer->data, capacity);
+    if (!data) return false;
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+// Apply every complete record of the log to the data file, then empty the log
+static bool replay_log(wal_t* wal) {
+    if (lseek(wal->log_fd, 0, SEEK_SET) < 0) return false;
+    wal_buffer_t buffer = {NULL, 0, 0};
+    size_t done = 0;
+    while (true) {
+        // Top up the buffer, stop at the end of the file
+        if (!reserve(&buffer, WAL_READ_SIZE)) {
+            free(buffer.data);
+            return false;
+        }
+        ssize_t res = read(wal->log_fd, buffer.data + buffer.size, WAL_READ_SIZE);
+        if (res < 0) {
+            if (errno == EINTR) continue;
+            free(buffer.data);
+            return false;
+        }
+        buffer.size += (size_t) res;
+        // Apply the complete records, stop at the first torn one
+        bool torn = false;
+        while (buffer.size - done >= sizeof(wal_header_t)) {
+            wal_header_t header;
+            memcpy(&header, buffer.data + done, sizeof(header));
+            if (header.magic != WAL_MAGIC) {
+                torn = true;
+                break;
+            }
+            if (buffer.size - done - sizeof(header) < header.length) break;
+            const char* payload = buffer.data + done + sizeof(header);
+            if (checksum(payload, header.length) != header.checksum) {
+                torn = true;
+                break;
+            }
+            size_t cursor = 0;
+            while (cursor + sizeof(wal_entry_t) <= header.length) {
+                wal_entry_t entry;
+                memcpy(&entry, payload + cursor, sizeof(entry));
+                cursor += sizeof(entry);
+                if (pwrite(wal->data_fd, payload + cursor, entry.size, (off_t) entry.offset) != (ssize_t) entry.size) {
+                    free(buffer.data);
+                    return false;
+                }
+                cursor += pad(entry.size);
+            }
+            done += sizeof(header) + header.length;
+        }
+        if (torn || res == 0) break;
+        // Drop the applied records from the buffer
+        memmove(buffer.data, buffer.data + done, buffer.size - done);
+        buffer.size -= done;
+        done = 0;
+    }
+    free(buffer.data);
+    // The data file must be durable before the log is dropped
+    if (fdatasync(wal->data_fd) != 0) return false;
+    if (ftruncate(wal->log_fd, 0) != 0 || lseek(wal->log_fd, 0, SEEK_SET) < 0) return false;
+    if (fdatasync(wal->log_fd) != 0) return false;
+    wal->log_size = 0;
+    return true;
+}
+
+// Flush the appended records; called and returns with the mutex held
+static void flush_locked(wal_t* wal) {
+    while (wal->flush_in_progress) {
+        pthread_cond_wait(&(wal->flushed), &(wal->mutex));
+    }
+    if (wal->durable_lsn >= wal->appended_lsn) return;
+    // Swap the buffers, so that committers keep appending during the I/O
+    wal_buffer_t* flushing = wal->appending;
+    wal->appending = wal->flushing;
+    wal->flushing = flushing;
+    uint64_t target = wal->appended_lsn;
+    wal->flush_in_progress = true;
+    pthread_mutex_unlock(&(wal->mutex));
+
+    write_all(wal->log_fd, flushing->data, flushing->size);
+    if (fdatasync(wal->log_fd) != 0) fail("log sync");
+    wal->log_size += flushing->size;
+    flushing->size = 0;
+
+    // Wake the committers of the batch before checkpointing
+    pthread_mutex_lock(&(wal->mutex));
+    wal->durable_lsn = target;
+    pthread_cond_broadcast(&(wal->flushed));
+    if (wal->log_size >= WAL_CHECKPOINT_SIZE) {
+        pthread_mutex_unlock(&(wal->mutex));
+        if (!replay_log(wal)) fail("checkpoint");
+        pthread_mutex_lock(&(wal->mutex));
+    }
+    wal->flush_in_progress = false;
+    pthread_cond_broadcast(&(wal->flushed));
+}
+
+static void* run_flusher(void* wal_ptr) {
+    wal_t* wal = (wal_t*) wal_ptr;
+    pthread_mutex_lock(&(wal->mutex));
+    while (!wal->stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (wal->interval_ms % 1000) * 1000000;
+        deadline.tv_sec += wal->interval_ms / 1000 + deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+        pthread_cond_timedwait(&(wal->wake), &(wal->mutex), &deadline);
+        flush_locked(wal);
+    }
+    pthread_mutex_unlock(&(wal->mutex));
+    return NULL;
+}
+
+const char* get_durable_path() {
+    const char* path = getenv("TM_DURABLE_PATH");
+    if (!path || *path == '\0') return NULL;
+    return path;
+}
+
+durability_t get_durability() {
+    const char* durability = getenv("TM_DURABILITY");
+    if (!durability) return DURABILITY_GROUP;
+    if (strcmp(durability, "sync") == 0) return DURABILITY_SYNC;
+    if (strcmp(durability, "async") == 0) return DURABILITY_ASYNC;
+    return DURABILITY_GROUP;
+}
+
+wal_t* open_wal(const char* path, size_t size, durability_t durability) {
+    wal_t* wal = (wal_t*) calloc(1, sizeof(wal_t));
+    if (!wal) return NULL;
+    wal->size = size;
+    wal->durability = durability;
+    wal->appending = &(wal->buffers[0]);
+    wal->flushing = &(wal->buffers[1]);
+    const char* interval = getenv("TM_DURABLE_INTERVAL_MS");
+    wal->interval_ms = interval ? atol(interval) : WAL_DEFAULT_INTERVAL_MS;
+    if (wal->interval_ms <= 0) wal->interval_ms = WAL_DEFAULT_INTERVAL_MS;
+
+    // Open the data file, exclusively, and make it cover the region
+    wal->data_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (wal->data_fd < 0) {
+        free(wal);
+        return NULL;
+    }
+    struct stat data_stat;
+    if (flock(wal->data_fd, LOCK_EX | LOCK_NB) != 0 || fstat(wal->data_fd, &data_stat) != 0
+     || ((size_t) data_stat.st_size < size && ftruncate(wal->data_fd, (off_t) size) != 0)) {
+        close(wal->data_fd);
+        free(wal);
+        return NULL;
+    }
+
+    // Open the log and recover
+    size_t path_length = strlen(path);
+    char* log_path = (char*) malloc(path_length + sizeof(".log"));
+    if (!log_path) {
+        close(wal->data_fd);
+        free(wal);
+        return NULL;
+    }
+    memcpy(log_path, path, path_length);
+    memcpy(log_path + path_length, ".log", sizeof(".log"));
+    wal->log_fd = open(log_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    free(log_path);
+    if (wal->log_fd < 0 || !replay_log(wal)) {
+        if (wal->log_fd >= 0) close(wal->log_fd);
+        close(wal->data_fd);
+        free(wal);
+        return NULL;
+    }
+
+    pthread_mutex_init(&(wal->mutex), NULL);
+    pthread_cond_init(&(wal->flushed), NULL);
+    pthread_cond_init(&(wal->wake), NULL);
+    if (durability == DURABILITY_ASYNC) {
+        wal->has_flusher = pthread_create(&(wal->flusher), NULL, run_flusher, wal) == 0;
+        if (!wal->has_flusher) wal->durability = DURABILITY_GROUP;
+    }
+    return wal;
+}
+
+void close_wal(wal_t* wal) {
+    if (!wal) return;
+    pthread_mutex_lock(&(wal->mutex));
+    wal->stopping = true;
+    pthread_cond_signal(&(wal->wake));
+    pthread_mutex_unlock(&(wal->mutex));
+    if (wal->has_flusher) pthread_join(wal->flusher, NULL);
+
+    // Flush what remains and checkpoint, so that the next tm_create starts
+    // with an empty log
+    pthread_mutex_lock(&(wal->mutex));
+    flush_locked(wal);
+    pthread_mutex_unlock(&(wal->mutex));
+    if (!replay_log(wal)) fail("checkpoint");
+
+    pthread_cond_destroy(&(wal->wake));
+    pthread_cond_destroy(&(wal->flushed));
+    pthread_mutex_destroy(&(wal->mutex));
+    free(wal->buffers[0].data);
+    free(wal->buffers[1].data);
+    close(wal->log_fd);
+    close(wal->data_fd);
+    free(wal);
+}
+
+// Only the first segment is logged (the rest of its last page is never read back)
+static bool is_durable(const wal_t* wal, const store_t* store, const void* base) {
+    return (size_t) ((const char*) store->address_to_be_written - (const char*) base) < wal->size;
+}
+
+uint64_t append_wal(wal_t* wal, const list_t* write_set, const void* base) {
+    // Size the record, stores are applied in program order (oldest last in the list)
+    size_t length = 0;
+    for (node_t* node = write_set->last; node; node = node->previous) {
+        store_t* store = (store_t*) node->content;
+        if (!is_durable(wal, store, base)) continue;
+        length += sizeof(wal_entry_t) + pad(store->size);
+    }
+    if (length == 0) return 0;
+
+    pthread_mutex_lock(&(wal->mutex));
+    wal_buffer_t* buffer = wal->appending;
+    if (!reserve(buffer, sizeof(wal_header_t) + length)) fail("log append");
+    char* record = buffer->data + buffer->size;
+    char* payload = record + sizeof(wal_header_t);
+    size_t cursor = 0;
+    for (node_t* node = write_set->last; node; node = node->previous) {
+        store_t* store = (store_t*) node->content;
+        if (!is_durable(wal, store, base)) continue;
+        wal_entry_t entry = {(uint64_t) ((const char*) store->address_to_be_written - (const char*) base), store->size};
+        memcpy(payload + cursor, &entry, sizeof(entry));
+        cursor += sizeof(entry);
+        memcpy(payload + cursor, store->value_to_be_written, store->size);
+        memset(payload + cursor + store->size, 0, pad(store->size) - store->size);
+        cursor += pad(store->size);
+    }
+    wal_header_t header = {WAL_MAGIC, length, checksum(payload, length)};
+    memcpy(record, &header, sizeof(header));
+    buffer->size += sizeof(header) + length;
+    wal->appended_lsn += sizeof(header) + length;
+    uint64_t lsn = wal->appended_lsn;
+
+    if (wal->durability == DURABILITY_SYNC) {
+        // Write and sync under the mutex: one record per fdatasync
+        write_all(wal->log_fd, buffer->data, buffer->size);
+        if (fdatasync(wal->log_fd) != 0) fail("log sync");
+        wal->log_size += buffer->size;
+        buffer->size = 0;
+        wal->durable_lsn = lsn;
+        if (wal->log_size >= WAL_CHECKPOINT_SIZE && !replay_log(wal)) fail("checkpoint");
+    }
+    pthread_mutex_unlock(&(wal->mutex));
+    return lsn;
+}
+
+void wait_wal(wal_t* wal, uint64_t lsn) {
+    if (wal->durability != DURABILITY_GROUP) return;
+    pthread_mutex_lock(&(wal->mutex));
+    while (wal->durable_lsn < lsn) {
+        if (wal->flush_in_progress) {
+            pthread_cond_wait(&(wal->flushed), &(wal->mutex));
+        } else {
+            flush_locked(wal);
+        }
+    }
+    pthread_mutex_unlock(&(wal->mutex));
+}
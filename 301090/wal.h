@@ -0,0 +1,62 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "list.h"
+
+// Durable region mode, enabled at tm_create by setting TM_DURABLE_PATH to the
+// path of the data file (the redo log is "<path>.log"). The region is a
+// private mapping of the data file, so in-flight writes never reach it: only
+// the committed write sets, appended to the redo log by tm_end, are applied to
+// the data file at recovery and at checkpoints. Only the first segment is
+// durable, so durable regions have no heap: tm_alloc returns nomem_alloc and
+// tm_free fails. TM_DURABILITY selects when tm_end returns:
+//   "sync":  once its own record is written and fdatasync'd
+//   "group": (default) once a batch including its record is fdatasync'd, by
+//            whichever committer leads the flush
+//   "async": right away, a background thread flushes every
+//            TM_DURABLE_INTERVAL_MS milliseconds (default 10)
+typedef enum durability {
+    DURABILITY_SYNC,
+    DURABILITY_GROUP,
+    DURABILITY_ASYNC
+} durability_t;
+
+typedef struct wal_buffer {
+    char* data;
+    size_t size;
+    size_t capacity;
+} wal_buffer_t;
+
+typedef struct wal {
+    int data_fd;
+    int log_fd;
+    size_t size;                 // Durable range, from the region start
+    durability_t durability;
+    pthread_mutex_t mutex;
+    pthread_cond_t flushed;      // Signaled when a flush completes
+    pthread_cond_t wake;         // Signaled to stop the flusher
+    wal_buffer_t buffers[2];     // Appended and flushing buffers
+    wal_buffer_t* appending;
+    wal_buffer_t* flushing;
+    bool flush_in_progress;
+    uint64_t appended_lsn;       // Log bytes appended so far
+    uint64_t durable_lsn;        // Log bytes known to be on disk
+    size_t log_size;             // Current log file size
+    long interval_ms;
+    bool has_flusher;
+    bool stopping;
+    pthread_t flusher;
+} wal_t;
+
+const char* get_durable_path();
+durability_t get_durability();
+wal_t* open_wal(const char* path, size_t size, durability_t durability);
+void close_wal(wal_t* wal);
+uint64_t append_wal(wal_t* wal, const list_t* write_set, const void* base);
+void wait_wal(wal_t* wal, uint64_t lsn);
+
+#endif /* WAL_H */
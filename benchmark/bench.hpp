@@ -0,0 +1,194 @@
+/**
+ * @file   bench.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Helpers shared by the micro-benchmarks.
+**/
+
+#pragma once
+
+// External headers
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+extern "C" {
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Parse a size with an optional binary suffix (K, M, G).
+ * @param text Null-terminated text to parse
+ * @return Parsed size (in bytes)
+**/
+static inline size_t parse_size(char const* text) {
+    char* end;
+    auto res = static_cast<size_t>(::std::strtoull(text, &end, 10));
+    switch (*end) {
+    case 'G': case 'g':
+        res <<= 10;
+        // Fallthrough
+    case 'M': case 'm':
+        res <<= 10;
+        // Fallthrough
+    case 'K': case 'k':
+        res <<= 10;
+        ++end;
+        break;
+    }
+    if (unlikely(end == text || *end != '\0'))
+        throw ::std::invalid_argument{"invalid size"};
+    return res;
+}
+
+/** Format a size with the largest exact binary suffix.
+ * @param size Size to format (in bytes)
+ * @return Formatted size
+**/
+static inline ::std::string format_size(size_t size) {
+    char const* suffixes[] = {"", "K", "M", "G", "T"};
+    size_t i = 0;
+    while (size >= 1024 && size % 1024 == 0 && i < 4) {
+        size /= 1024;
+        ++i;
+    }
+    return ::std::to_string(size) + suffixes[i];
+}
+
+/** Fast per-thread pseudo-random generator (xorshift64*).
+**/
+class Random final {
+private:
+    uint64_t state; // Non-null state
+public:
+    /** Seed constructor.
+     * @param seed Seed to use
+    **/
+    Random(uint64_t seed): state{seed * UINT64_C(0x9e3779b97f4a7c15) + 1} {}
+public:
+    /** Draw a number in [0, bound).
+     * @param bound Exclusive upper bound
+     * @return Drawn number
+    **/
+    uint64_t operator()(uint64_t bound) noexcept {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return (state * UINT64_C(0x2545f4914f6cdd1d)) % bound;
+    }
+};
+
+/** Hardware event counter over the calling thread and the threads it spawns afterwards.
+**/
+class PerfCounter final: private NonCopyable {
+private:
+    int fd; // Event file descriptor, negative if unavailable
+public:
+    /** Open constructor, the counter is unavailable if the event cannot be opened (e.g. 'perf_event_paranoid').
+     * @param type   Event type (e.g. 'PERF_TYPE_HW_CACHE')
+     * @param config Event configuration
+    **/
+    PerfCounter(uint32_t type, uint64_t config) {
+        struct ::perf_event_attr attr;
+        ::std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    /** Close destructor.
+    **/
+    ~PerfCounter() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+public:
+    /** Check whether the counter is available.
+     * @return Whether the counter is available
+    **/
+    bool available() const noexcept {
+        return fd >= 0;
+    }
+    /** Reset and start counting.
+    **/
+    void start() noexcept {
+        if (fd < 0)
+            return;
+        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    /** Stop counting, once the spawned threads were joined.
+     * @return Counted events
+    **/
+    uint64_t stop() noexcept {
+        if (fd < 0)
+            return 0;
+        ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t res;
+        if (::read(fd, &res, sizeof(res)) != sizeof(res))
+            return 0;
+        return res;
+    }
+};
+
+/** Run the given function in the given number of threads, starting as simultaneously as possible.
+ * @param nbthreads Number of threads
+ * @param func      Function to run (unsigned int thread index -> void)
+ * @return Elapsed time between the synchronized start and the last thread termination (in ns)
+**/
+template<class Func> static Chrono::Tick run_threads(unsigned int nbthreads, Func&& func) {
+    Barrier barrier{nbthreads + 1};
+    ::std::vector<::std::thread> threads;
+    threads.reserve(nbthreads);
+    for (unsigned int i = 0; i < nbthreads; ++i) {
+        threads.emplace_back([&](unsigned int i) {
+            barrier.sync();
+            func(i);
+        }, i);
+    }
+    Chrono chrono;
+    barrier.sync();
+    chrono.start();
+    for (auto&& thread: threads)
+        thread.join();
+    chrono.stop();
+    return chrono.get_tick();
+}
+
+/** Get the default number of threads.
+ * @return Number of hardware threads (16 if unknown)
+**/
+static inline unsigned int default_nbthreads() noexcept {
+    auto res = ::std::thread::hardware_concurrency();
+    return res > 0 ? res : 16;
+}
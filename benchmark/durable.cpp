@@ -0,0 +1,116 @@
+/**
+ * @file   durable.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Commit throughput of the bank workload (update transactions only) on a volatile region and on durable regions in each durability mode ('TM_DURABILITY').
+ * No allocation transactions: durable regions only persist their first segment, and refuse 'tm_alloc'.
+**/
+
+// External headers
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+#include "workload.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 100000ul;
+        ::std::string dir = ".";
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--dir") == 0) {
+                dir = argv[2];
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "durable") << " [--threads <n>] [--txs <per thread>] [--dir <data directory>] <library path>" << ::std::endl;
+            return 1;
+        }
+        auto const path = dir + "/durable-bench.dat";
+        auto const log  = path + ".log";
+        char const* modes[] = {nullptr, "sync", "group", "async"};
+        // Run the benchmark
+        TransactionalLibrary tl{argv[1]};
+        ::std::printf("%8s %12s %14s\n", "mode", "time (ms)", "commits/s");
+        for (auto mode: modes) {
+            if (mode) {
+                ::std::remove(path.c_str());
+                ::std::remove(log.c_str());
+                ::setenv("TM_DURABLE_PATH", path.c_str(), 1);
+                ::setenv("TM_DURABILITY", mode, 1);
+            } else {
+                ::unsetenv("TM_DURABLE_PATH");
+            }
+            Chrono::Tick tick;
+            {
+                WorkloadBank bank{tl, nbthreads, nbtxs, 32 * nbthreads, 1024 * nbthreads, 100, 0.f, 0.f}; // No 'tm_alloc' on durable regions
+                auto error = bank.init();
+                if (unlikely(error)) {
+                    ::std::cerr << error << ::std::endl;
+                    return 1;
+                }
+                tick = run_threads(nbthreads, [&](unsigned int id) {
+                    auto error = bank.run(id, id + 1);
+                    if (unlikely(error))
+                        ::std::cerr << error << ::std::endl;
+                });
+                run_threads(nbthreads, [&](unsigned int id) {
+                    auto error = bank.check(id, id + 1);
+                    if (unlikely(error))
+                        ::std::cerr << error << ::std::endl;
+                });
+            } // Region destroyed here: the log is flushed and checkpointed outside of the measure
+            auto const total = static_cast<double>(nbtxs) * nbthreads;
+            ::std::printf("%8s %12.1f %14.0f\n", mode ? mode : "volatile", tick / 1e6, total / (tick / 1e9));
+            ::std::fflush(stdout);
+        }
+        ::std::remove(path.c_str());
+        ::std::remove(log.c_str());
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file   heatmap.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * Conflict heatmap ('TM_HEATMAP', supported by some libraries) of the bank workload in the '--dynamic' grading configuration, with uniform then skewed account selection: each run writes its heatmap, whose hottest ranges are printed along with the share of the aborts on the hot accounts.
+**/
+
+// External headers
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+#include "workload.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 0ul;
+        auto seed      = 453ul;
+        auto skew      = 0.9f;
+        auto hot       = 0.1f;
+        ::std::string prefix{"heatmap"};
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--seed") == 0) {
+                seed = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--skew") == 0) {
+                skew = ::std::stof(argv[2]);
+            } else if (::std::strcmp(argv[1], "--hot") == 0) {
+                hot = ::std::stof(argv[2]);
+            } else if (::std::strcmp(argv[1], "--out") == 0) {
+                prefix = argv[2];
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0 || skew < 0 || skew >= 1 || hot <= 0 || hot > 1) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "heatmap") << " [--threads <n>] [--txs <per thread>] [--seed <seed>] [--skew <skew in [0, 1)>] [--hot <fraction of hot accounts>] [--out <heatmap file prefix>] <library path>" << ::std::endl;
+            return 1;
+        }
+        if (nbtxs == 0) // Same as the grading
+            nbtxs = 400000ul / nbthreads;
+        TransactionalLibrary tl{argv[1]};
+        auto const nbaccounts = 32 * nbthreads;
+        // Hot accounts: the first ones of the first segment, after its 3 header words
+        auto const nbhot = static_cast<size_t>(hot * nbaccounts + 0.5f);
+        auto const hot_begin = 3 * sizeof(void*);
+        auto const hot_end = hot_begin + nbhot * sizeof(WorkloadBank::Balance);
+        for (auto run_skew: {0.f, skew}) {
+            auto const path = prefix + (run_skew > 0.f ? "-skewed.txt" : "-uniform.txt");
+            ::setenv("TM_HEATMAP", path.c_str(), 1);
+            { // Run the workload, the heatmap being written when the region is destroyed
+                WorkloadBank bank{tl, nbthreads, nbtxs, nbaccounts, 1024 * nbthreads, 100, 0.05f, 0.2f, false, false, run_skew};
+                auto error = bank.init();
+                if (unlikely(error)) {
+                    ::std::cerr << error << ::std::endl;
+                    return 1;
+                }
+                ::std::atomic<uint_fast64_t> aborts{0};
+                ::std::atomic<bool> failed{false};
+                auto tick = run_threads(nbthreads, [&](unsigned int id) {
+                    transactional_aborts = 0;
+                    auto error = bank.run(id, seed + id);
+                    if (unlikely(error)) {
+                        ::std::cerr << error << ::std::endl;
+                        failed = true;
+                    }
+                    aborts.fetch_add(transactional_aborts);
+                });
+                if (failed)
+                    return 1;
+                ::std::printf("skew %.2f: %.1f ms, %lu aborts, heatmap in '%s'\n", run_skew, tick / 1e6, static_cast<unsigned long>(aborts.load()), path.c_str());
+            }
+            ::unsetenv("TM_HEATMAP");
+            // Read the heatmap back: stripe lines, then the ranges after the second comment line
+            ::std::ifstream file{path};
+            if (!file) {
+                ::std::cout << "  (no heatmap written, the library may not support 'TM_HEATMAP')" << ::std::endl << ::std::endl;
+                continue;
+            }
+            ::std::string line;
+            auto comments = 0;
+            auto total = 0ull;
+            auto on_hot = 0ull;
+            auto ranges = 0;
+            while (::std::getline(file, line)) {
+                if (line.empty())
+                    continue;
+                if (line[0] == '#') {
+                    if (++comments == 3)
+                        ::std::printf("  %12s %12s %14s %8s %10s\n", "segment", "offset", "size (bytes)", "aborts", "at commit");
+                    continue;
+                }
+                ::std::istringstream fields{line};
+                if (comments < 3) { // Stripe: stripe region_offset segment segment_offset aborts reads commits
+                    unsigned long long stripe, count, reads, commits;
+                    long long region_offset, segment, offset;
+                    fields >> stripe >> region_offset >> segment >> offset >> count >> reads >> commits;
+                    total += count;
+                    if (segment == 0 && offset >= static_cast<long long>(hot_begin) && offset < static_cast<long long>(hot_end))
+                        on_hot += count;
+                } else if (ranges++ < 5) { // Range: first_stripe last_stripe segment segment_offset size aborts reads commits
+                    unsigned long long first, last, size, count, reads, commits;
+                    long long segment, offset;
+                    fields >> first >> last >> segment >> offset >> size >> count >> reads >> commits;
+                    ::std::printf("  %12lld %12lld %14llu %8llu %10llu\n", segment, offset, size, count, commits);
+                }
+            }
+            if (total > 0)
+                ::std::printf("  %.1f%% of the %llu sampled aborts on the first %zu accounts\n", 100. * on_hot / total, total, nbhot);
+            ::std::cout << ::std::endl;
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
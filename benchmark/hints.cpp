@@ -0,0 +1,121 @@
+/**
+ * @file   hints.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * Abort rate and throughput of the bank workload in the '--dynamic' grading configuration (or with more long transactions), with transactions begun with hints ('tm_begin_hinted': expected read/write set sizes and site IDs), and without; then the statistics the library kept by site.
+**/
+
+// External headers
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+#include "workload.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 0ul;
+        auto seed      = 453ul;
+        auto prob_long = 0.05f;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--seed") == 0) {
+                seed = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--long") == 0) {
+                prob_long = ::std::stof(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0 || prob_long < 0 || prob_long > 1) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "hints") << " [--threads <n>] [--txs <per thread>] [--seed <seed>] [--long <probability of a long transaction>] <library path>" << ::std::endl;
+            return 1;
+        }
+        if (nbtxs == 0) // Same as the grading
+            nbtxs = 400000ul / nbthreads;
+        TransactionalLibrary tl{argv[1]};
+        if (!tl.has_hints())
+            ::std::cout << "(the library does not provide 'tm_begin_hinted', both runs are identical)" << ::std::endl;
+        // Run the benchmark, with the parameters of 'grading --dynamic'
+        ::std::printf("%8s %12s %14s %12s %12s\n", "hinted", "time (ms)", "txs/s", "aborts", "abort rate");
+        for (auto hinted: {false, true}) {
+            WorkloadBank bank{tl, nbthreads, nbtxs, 32 * nbthreads, 1024 * nbthreads, 100, prob_long, 0.2f, false, hinted};
+            auto error = bank.init();
+            if (unlikely(error)) {
+                ::std::cerr << error << ::std::endl;
+                return 1;
+            }
+            ::std::atomic<uint_fast64_t> aborts{0};
+            ::std::atomic<bool> failed{false};
+            auto tick = run_threads(nbthreads, [&](unsigned int id) {
+                transactional_aborts = 0;
+                auto error = bank.run(id, seed + id);
+                if (unlikely(error)) {
+                    ::std::cerr << error << ::std::endl;
+                    failed = true;
+                }
+                aborts.fetch_add(transactional_aborts);
+            });
+            if (failed)
+                return 1;
+            auto const txs = static_cast<double>(nbtxs) * nbthreads;
+            ::std::printf("%8s %12.1f %14.0f %12lu %12.4f\n", hinted ? "yes" : "no", tick / 1e6, txs / (tick / 1e9), static_cast<unsigned long>(aborts.load()), aborts.load() / (aborts.load() + txs));
+            ::std::fflush(stdout);
+            if (!hinted)
+                continue;
+            // Statistics by site (including the transactions of 'init' and 'check')
+            struct { char const* name; uint32_t site; } const sites[] = {
+                {"long", WorkloadBank::site_long}, {"alloc", WorkloadBank::site_alloc}, {"short", WorkloadBank::site_short}
+            };
+            ::std::printf("\n%8s %12s %12s %12s %12s\n", "site", "commits", "aborts", "max reads", "max writes");
+            for (auto&& site: sites) {
+                STM::tm_site_stats stats;
+                if (!bank.get_tm().site_stats(site.site, &stats)) {
+                    ::std::printf("%8s %12s\n", site.name, "-");
+                    continue;
+                }
+                ::std::printf("%8s %12lu %12lu %12lu %12lu\n", site.name, static_cast<unsigned long>(stats.commits), static_cast<unsigned long>(stats.aborts), static_cast<unsigned long>(stats.reads), static_cast<unsigned long>(stats.writes));
+            }
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * @file   region.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Random single-word transactions over regions of growing size, for each page backing mode ('TM_HUGE_PAGES'), reporting throughput and dTLB read misses per transaction.
+**/
+
+// External headers
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 1000000ul;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc < 2 || nbthreads == 0) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "region") << " [--threads <n>] [--txs <per thread>] <library path> [<region size>...]" << ::std::endl;
+            return 1;
+        }
+        ::std::vector<size_t> sizes;
+        for (auto i = 2; i < argc; ++i)
+            sizes.push_back(parse_size(argv[i]));
+        if (sizes.empty())
+            sizes = {size_t{1} << 20, size_t{16} << 20, size_t{256} << 20, size_t{1} << 30, size_t{4} << 30, size_t{8} << 30};
+        char const* modes[] = {"off", "thp", "hugetlb"};
+        // Run the benchmark
+        TransactionalLibrary tl{argv[1]};
+        PerfCounter dtlb{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+        ::std::printf("%8s %8s %12s %12s %14s\n", "size", "mode", "time (ms)", "Mtx/s", "dTLB miss/tx");
+        for (auto size: sizes) {
+            for (auto mode: modes) {
+                ::setenv("TM_HUGE_PAGES", mode, 1);
+                TransactionalMemory tm{tl, sizeof(uintptr_t), size, ::std::chrono::minutes{10}};
+                auto const start  = reinterpret_cast<uintptr_t*>(tm.get_start());
+                auto const nbword = size / sizeof(uintptr_t);
+                // Pre-fault the region (one word per page) so that only translation costs remain
+                run_threads(nbthreads, [&](unsigned int id) {
+                    auto const stride = 4096 / sizeof(uintptr_t);
+                    for (auto i = id * stride; i < nbword; i += nbthreads * stride) {
+                        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                            Shared<uintptr_t> word{tx, start + i};
+                            word = word.read() + 1;
+                        });
+                    }
+                });
+                // Random read-modify-write transactions
+                dtlb.start();
+                auto tick = run_threads(nbthreads, [&](unsigned int id) {
+                    Random random{id + 1};
+                    for (auto n = nbtxs; n > 0; --n) {
+                        auto const i = random(nbword);
+                        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                            Shared<uintptr_t> word{tx, start + i};
+                            word = word.read() + 1;
+                        });
+                    }
+                });
+                auto misses = dtlb.stop();
+                auto const total = static_cast<double>(nbtxs) * nbthreads;
+                ::std::printf("%8s %8s %12.1f %12.3f ", format_size(size).c_str(), mode, tick / 1e6, total / (tick / 1e3));
+                if (dtlb.available()) {
+                    ::std::printf("%14.3f\n", misses / total);
+                } else {
+                    ::std::printf("%14s\n", "n/a");
+                }
+                ::std::fflush(stdout);
+            }
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file   retry.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Throughput and attempts per commit of highly contended transactions (increments over a few hot words), retried by throwing through the harness ('transactional'), by a plain loop without exceptions nor backoff, or by the library ('tm_run', with its own backoff).
+**/
+
+// External headers
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+
+// -------------------------------------------------------------------------- //
+
+using Word = uintptr_t;
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 100000ul;
+        auto nbhot     = 4ul;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--hot") == 0) {
+                nbhot = ::std::stoul(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0 || nbhot == 0) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "retry") << " [--threads <n>] [--txs <per thread>] [--hot <words>] <library path>" << ::std::endl;
+            return 1;
+        }
+        TransactionalLibrary tl{argv[1]};
+        if (!tl.has_run())
+            ::std::cout << "(the library does not provide 'tm_run', the harness loop is used instead)" << ::std::endl;
+        char const* names[] = {"exceptions", "loop", "tm_run"};
+        ::std::printf("%12s %12s %14s %18s\n", "retry", "time (ms)", "commits/s", "attempts/commit");
+        for (auto strategy = 0; strategy < 3; ++strategy) {
+            TransactionalMemory tm{tl, sizeof(Word), nbhot * sizeof(Word)};
+            auto const hot = static_cast<Word*>(tm.get_start());
+            ::std::atomic<uint_fast64_t> aborts{0};
+            auto tick = run_threads(nbthreads, [&](unsigned int id) {
+                Random random{id + 1};
+                transactional_aborts = 0;
+                for (size_t i = 0; i < nbtxs; ++i) {
+                    auto target = random(nbhot);
+                    // Read every hot word, then increment one of them
+                    auto body = [&](TransactionalMemory::TX tx) noexcept {
+                        Word value = 0;
+                        for (size_t j = 0; j < nbhot; ++j) {
+                            Word local;
+                            if (!tm.read(tx, hot + j, sizeof(Word), &local))
+                                return false;
+                            if (j == target)
+                                value = local + 1;
+                        }
+                        return tm.write(tx, &value, sizeof(Word), hot + target);
+                    };
+                    switch (strategy) {
+                    case 0:
+                        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                            Shared<Word[]> words{tx, hot};
+                            Word value = 0;
+                            for (size_t j = 0; j < nbhot; ++j) {
+                                Word local = words.read(j);
+                                if (j == target)
+                                    value = local + 1;
+                            }
+                            words.write(target, value);
+                        });
+                        break;
+                    case 1:
+                        while (true) {
+                            auto tx = tm.begin(false);
+                            if (body(tx) && tm.end(tx))
+                                break;
+                            ++transactional_aborts;
+                        }
+                        break;
+                    default:
+                        transactional_run(tm, Transaction::Mode::read_write, body);
+                        break;
+                    }
+                }
+                aborts.fetch_add(transactional_aborts);
+            });
+            // Every committed increment must be there
+            auto sum = transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+                Shared<Word[]> words{tx, hot};
+                Word sum = 0;
+                for (size_t j = 0; j < nbhot; ++j)
+                    sum += words.read(j);
+                return sum;
+            });
+            auto const commits = static_cast<double>(nbtxs) * nbthreads;
+            if (sum != nbtxs * nbthreads) {
+                ::std::cerr << "Lost increment(s): " << sum << " instead of " << nbtxs * nbthreads << ::std::endl;
+                return 1;
+            }
+            ::std::printf("%12s %12.1f %14.0f %18.3f\n", names[strategy], tick / 1e6, commits / (tick / 1e9), (commits + aborts.load()) / commits);
+            ::std::fflush(stdout);
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
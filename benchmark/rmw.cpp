@@ -0,0 +1,111 @@
+/**
+ * @file   rmw.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Throughput of the counter decrements of the check workload ('WorkloadBank::check'), as full transactions, as single-word operations ('tm_fetch_add', 'tm_compare_swap' loop), and mixing full transactions with single-word operations.
+**/
+
+// External headers
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 200000ul;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "rmw") << " [--threads <n>] [--txs <decrements per thread>] <library path>" << ::std::endl;
+            return 1;
+        }
+        TransactionalLibrary tl{argv[1]};
+        if (!tl.has_rmw())
+            ::std::cout << "(the library does not provide single-word operations, they run as full transactions)" << ::std::endl;
+        char const* names[] = {"transaction", "fetch_add", "cas loop", "mixed"};
+        ::std::printf("%12s %12s %14s\n", "decrement", "time (ms)", "decrements/s");
+        for (auto mode = 0; mode < 4; ++mode) {
+            TransactionalMemory tm{tl, sizeof(uint64_t), sizeof(uint64_t)};
+            auto const counter = tm.get_start();
+            auto const init = static_cast<uint64_t>(nbtxs) * nbthreads;
+            tm.swap(counter, init);
+            auto tick = run_threads(nbthreads, [&](unsigned int id) {
+                // Mixed: even threads use full transactions, odd ones single-word operations
+                auto use_transaction = mode == 0 || (mode == 3 && id % 2 == 0);
+                auto last = init;
+                for (size_t i = 0; i < nbtxs; ++i) {
+                    if (use_transaction) {
+                        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                            Shared<uint64_t> shared{tx, counter};
+                            shared = shared.read() - 1;
+                        });
+                    } else if (mode == 2) {
+                        while (true) {
+                            auto previous = tm.compare_swap(counter, last, last - 1);
+                            if (previous == last)
+                                break;
+                            last = previous;
+                        }
+                        --last;
+                    } else {
+                        tm.fetch_add(counter, static_cast<uint64_t>(-1));
+                    }
+                }
+            });
+            auto const final_value = tm.compare_swap(counter, 0, 0);
+            if (final_value != 0) {
+                ::std::cerr << "Lost decrement(s): counter at " << final_value << " instead of 0" << ::std::endl;
+                return 1;
+            }
+            auto const total = static_cast<double>(init);
+            ::std::printf("%12s %12.1f %14.0f\n", names[mode], tick / 1e6, total / (tick / 1e9));
+            ::std::fflush(stdout);
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
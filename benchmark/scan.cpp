@@ -0,0 +1,149 @@
+/**
+ * @file   scan.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Scan throughput of a large array in shared memory, read one element at a time ('tm_read') or in bulk ('tm_read_range'), in read-only and read-write transactions, optionally against concurrent writers.
+**/
+
+// External headers
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+
+// -------------------------------------------------------------------------- //
+
+using Element = intptr_t;
+
+/** Scan the whole array in one transaction and sum it.
+ * @param tm    Transactional memory holding the array
+ * @param mode  Transaction mode
+ * @param bulk  Whether to read the array in bulk
+ * @param count Number of elements
+ * @param local Private buffer of (at least) 'count' elements
+ * @return Sum of the elements
+**/
+static Element scan(TransactionalMemory const& tm, Transaction::Mode mode, bool bulk, size_t count, Element* local) {
+    return transactional(tm, mode, [&](Transaction& tx) {
+        Shared<Element[]> array{tx, tm.get_start()};
+        auto sum = Element{0};
+        if (bulk) {
+            array.read(0, count, local);
+            for (size_t i = 0; i < count; ++i)
+                sum += local[i];
+        } else {
+            for (size_t i = 0; i < count; ++i)
+                sum += array.read(i);
+        }
+        return sum;
+    });
+}
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbwriters = 0u;
+        auto count     = 65536ul;
+        auto nbscans   = 200ul;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--writers") == 0) {
+                nbwriters = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--elements") == 0) {
+                count = parse_size(argv[2]);
+            } else if (::std::strcmp(argv[1], "--scans") == 0) {
+                nbscans = ::std::stoul(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0 || count < 2) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "scan") << " [--threads <n>] [--writers <n>] [--elements <count>] [--scans <per thread>] <library path>" << ::std::endl;
+            return 1;
+        }
+        TransactionalLibrary tl{argv[1]};
+        // Element i holds i; writers move units between elements, keeping the sum
+        auto const expected = static_cast<Element>(count * (count - 1) / 2);
+        ::std::printf("%10s %6s %12s %14s %12s %10s\n", "mode", "bulk", "time (ms)", "elements/s", "ns/element", "GB/s");
+        for (auto mode: {Transaction::Mode::read_only, Transaction::Mode::read_write}) {
+            for (auto bulk: {false, true}) {
+                TransactionalMemory tm{tl, alignof(Element), count * sizeof(Element)};
+                transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                    Shared<Element[]> array{tx, tm.get_start()};
+                    ::std::vector<Element> init(count);
+                    for (size_t i = 0; i < count; ++i)
+                        init[i] = static_cast<Element>(i);
+                    array.write(0, count, init.data());
+                });
+                ::std::atomic<unsigned int> running{nbthreads};
+                ::std::atomic<bool> failed{false};
+                auto tick = run_threads(nbthreads + nbwriters, [&](unsigned int id) {
+                    if (id < nbthreads) {
+                        ::std::vector<Element> local(count);
+                        for (size_t i = 0; i < nbscans; ++i) {
+                            if (unlikely(scan(tm, mode, bulk, count, local.data()) != expected))
+                                failed = true;
+                        }
+                        running.fetch_sub(1);
+                        return;
+                    }
+                    Random random{id + 1};
+                    while (running.load() > 0) {
+                        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                            Shared<Element[]> array{tx, tm.get_start()};
+                            auto from = random(count);
+                            auto to   = random(count);
+                            array[from] = array[from].read() - 1;
+                            array[to]   = array[to].read() + 1;
+                        });
+                    }
+                });
+                if (failed) {
+                    ::std::cerr << "Inconsistent scan detected" << ::std::endl;
+                    return 1;
+                }
+                auto const elements = static_cast<double>(count) * nbscans * nbthreads;
+                ::std::printf("%10s %6s %12.1f %14.0f %12.2f %10.2f\n", mode == Transaction::Mode::read_only ? "read-only" : "read-write", bulk ? "yes" : "no", tick / 1e6, elements / (tick / 1e9), tick / elements, elements * sizeof(Element) / tick);
+                ::std::fflush(stdout);
+            }
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,210 @@
+/**
+ * @file   snapshot.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Online snapshots ('tm_snapshot') of a region running the dynamic bank workload: snapshot duration and size, writer throughput with and without concurrent snapshots, and consistency of every snapshot taken (bank invariant checked on the stream).
+**/
+
+// External headers
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+#include "workload.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Snapshot stream buffered in memory.
+**/
+class Stream final {
+private:
+    ::std::vector<char> data; // Stream content
+public:
+    /** Sink callback for 'tm_snapshot'.
+     * @param context Target stream
+     * @param piece   Piece of the stream
+     * @param size    Size of the piece
+     * @return Always 'true'
+    **/
+    static bool sink(void* context, void const* piece, size_t size) {
+        auto& data = static_cast<Stream*>(context)->data;
+        auto const bytes = static_cast<char const*>(piece);
+        data.insert(data.end(), bytes, bytes + size);
+        return true;
+    }
+    /** Forget the previous content.
+    **/
+    void clear() noexcept {
+        data.clear();
+    }
+    /** Get the size of the stream.
+     * @return Size (in bytes)
+    **/
+    auto size() const noexcept {
+        return data.size();
+    }
+    /** Check the bank invariant on the snapshot: the balances of the accounts and the parities sum to the initial balance times the number of accounts.
+     * @param start        Address of the first segment in the live region
+     * @param init_balance Initial account balance
+     * @return Whether the invariant holds
+    **/
+    bool check_bank(void const* start, WorkloadBank::Balance init_balance) const {
+        using Balance = WorkloadBank::Balance;
+        struct Header { // Layout of an account segment (see 'WorkloadBank')
+            size_t  count;
+            void*   next;
+            Balance parity;
+            Balance accounts[];
+        };
+        ::std::map<uint64_t, char const*> segments;
+        for (size_t cursor = 0; cursor + sizeof(STM::tm_snapshot_segment) <= data.size();) {
+            STM::tm_snapshot_segment segment;
+            ::std::memcpy(&segment, data.data() + cursor, sizeof(segment));
+            cursor += sizeof(segment);
+            if (cursor + segment.size > data.size())
+                return false;
+            segments[segment.offset] = data.data() + cursor;
+            cursor += segment.size;
+        }
+        auto count = 0ul;
+        auto sum   = Balance{0};
+        auto offset = uint64_t{0};
+        while (true) {
+            auto found = segments.find(offset);
+            if (found == segments.end())
+                return false;
+            auto header = reinterpret_cast<Header const*>(found->second);
+            count += header->count;
+            sum += header->parity;
+            for (size_t i = 0; i < header->count; ++i)
+                sum += header->accounts[i];
+            if (!header->next)
+                break;
+            offset = static_cast<char const*>(header->next) - static_cast<char const*>(start);
+        }
+        return sum == static_cast<Balance>(init_balance * count);
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 100000ul;
+        auto accounts  = 4096ul;
+        auto interval  = 10ul;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--accounts") == 0) {
+                accounts = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--interval") == 0) {
+                interval = ::std::stoul(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0 || accounts < 2) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "snapshot") << " [--threads <n>] [--txs <per thread>] [--accounts <per segment>] [--interval <ms between snapshots>] <library path>" << ::std::endl;
+            return 1;
+        }
+        TransactionalLibrary tl{argv[1]};
+        if (!tl.has_snapshot()) {
+            ::std::cout << "The library does not provide 'tm_snapshot'" << ::std::endl;
+            return 1;
+        }
+        auto const init_balance = WorkloadBank::Balance{100};
+        // Run the benchmark, without then with a concurrent snapshotting thread
+        ::std::printf("%10s %12s %14s %10s %12s %12s %12s %8s\n", "snapshots", "time (ms)", "commits/s", "taken", "mean (ms)", "max (ms)", "size", "valid");
+        for (auto with_snapshots: {false, true}) {
+            WorkloadBank bank{tl, nbthreads, nbtxs, accounts, 2 * accounts, init_balance, 0.f, 0.01f};
+            auto error = bank.init();
+            if (unlikely(error)) {
+                ::std::cerr << error << ::std::endl;
+                return 1;
+            }
+            ::std::atomic<unsigned int> running{nbthreads};
+            Stream stream;
+            auto taken = 0ul;
+            auto valid = 0ul;
+            auto total = Chrono::Tick{0};
+            auto worst = Chrono::Tick{0};
+            auto size  = size_t{0};
+            auto tick = run_threads(nbthreads + 1, [&](unsigned int id) {
+                if (id < nbthreads) {
+                    auto error = bank.run(id, id + 1);
+                    if (unlikely(error))
+                        ::std::cerr << error << ::std::endl;
+                    running.fetch_sub(1);
+                    return;
+                }
+                while (with_snapshots && running.load() > 0) {
+                    stream.clear();
+                    Chrono chrono;
+                    chrono.start();
+                    auto done = bank.get_tm().snapshot(Stream::sink, &stream);
+                    chrono.stop();
+                    if (!done)
+                        continue;
+                    ++taken;
+                    total += chrono.get_tick();
+                    worst = ::std::max(worst, chrono.get_tick());
+                    size = stream.size();
+                    if (stream.check_bank(bank.get_tm().get_start(), init_balance))
+                        ++valid;
+                    ::std::this_thread::sleep_for(::std::chrono::milliseconds(interval));
+                }
+            });
+            auto const commits = static_cast<double>(nbtxs) * nbthreads;
+            ::std::printf("%10s %12.1f %14.0f %10lu %12.3f %12.3f %12s %8lu\n", with_snapshots ? "on" : "off", tick / 1e6, commits / (tick / 1e9), taken, taken > 0 ? total / 1e6 / taken : 0., worst / 1e6, format_size(size).c_str(), valid);
+            ::std::fflush(stdout);
+            if (valid != taken) {
+                ::std::cerr << "Inconsistent snapshot(s) detected" << ::std::endl;
+                return 1;
+            }
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file   startup.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Latency of 'tm_create' and 'tm_destroy', and resident memory right after creation, for region sizes from 4K to 16G.
+**/
+
+// External headers
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Get the resident set size of the process.
+ * @return Resident set size (in bytes)
+**/
+static size_t get_rss() {
+    auto file = ::std::fopen("/proc/self/statm", "r");
+    if (unlikely(!file))
+        return 0;
+    unsigned long size, resident;
+    auto res = ::std::fscanf(file, "%lu %lu", &size, &resident);
+    ::std::fclose(file);
+    if (unlikely(res != 2))
+        return 0;
+    return resident * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbrepeats = 10ul;
+        if (argc > 2 && ::std::strcmp(argv[1], "--repeats") == 0) {
+            nbrepeats = ::std::max(::std::stoul(argv[2]), 1ul);
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc < 2) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "startup") << " [--repeats <n>] <library path> [<region size>...]" << ::std::endl;
+            return 1;
+        }
+        ::std::vector<size_t> sizes;
+        for (auto i = 2; i < argc; ++i)
+            sizes.push_back(parse_size(argv[i]));
+        if (sizes.empty()) {
+            for (auto size = size_t{4} << 10; size <= (size_t{16} << 30); size <<= 2)
+                sizes.push_back(size);
+        }
+        // Load the library, and call 'tm_create'/'tm_destroy' directly: 'TransactionalMemory' runs them on a new thread
+        // (see 'bounded_run'), whose spawn and join would be timed too, and bounds them below the time large regions may take
+        TransactionalLibrary tl{argv[1]};
+        // Run the benchmark, reporting medians
+        ::std::printf("%8s %14s %14s %14s\n", "size", "create (us)", "destroy (us)", "RSS (KB)");
+        for (auto size: sizes) {
+            ::std::vector<Chrono::Tick> creates;
+            ::std::vector<Chrono::Tick> destroys;
+            ::std::vector<size_t> rsss;
+            for (auto i = nbrepeats; i > 0; --i) {
+                auto const rss = get_rss();
+                Chrono chrono;
+                chrono.start();
+                auto shared = tl.create(size, sizeof(uintptr_t));
+                chrono.stop();
+                if (unlikely(shared == STM::invalid_shared))
+                    break;
+                creates.push_back(chrono.get_tick());
+                auto const now = get_rss();
+                rsss.push_back(now > rss ? now - rss : 0);
+                chrono.reset();
+                chrono.start();
+                tl.destroy(shared);
+                chrono.stop();
+                destroys.push_back(chrono.get_tick());
+            }
+            if (creates.size() < nbrepeats) {
+                ::std::printf("%8s %14s %14s %14s\n", format_size(size).c_str(), "failed", "-", "-");
+                continue;
+            }
+            auto median = [](auto& values) {
+                ::std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+                return values[values.size() / 2];
+            };
+            ::std::printf("%8s %14.1f %14.1f %14zu\n", format_size(size).c_str(), median(creates) / 1e3, median(destroys) / 1e3, median(rsss) / 1024);
+            ::std::fflush(stdout);
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,175 @@
+/**
+ * @file   tracejson.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * Convert an event trace ('TM_TRACE', written by some libraries at region destruction) to the Chrome trace-event JSON format, for chrome://tracing or the Perfetto UI: one track per thread, transactions and their commit locking as slices, aborts and read validation failures as instant events.
+**/
+
+// External headers
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// -------------------------------------------------------------------------- //
+
+/** Trace event, as written by the library.
+**/
+struct Event {
+    uint64_t tsc;    // Time stamp counter
+    uint32_t tx;     // Transaction ID
+    uint16_t type;   // Event type, see 'Type'
+    uint16_t detail; // Type-dependent detail
+};
+static_assert(sizeof(Event) == 16, "Event must be 16 bytes long");
+
+/** Event types.
+**/
+enum Type: uint16_t {
+    begin     = 1, // Detail: whether read-only
+    read_fail = 2, // Detail: abort reason
+    lock      = 3,
+    locked    = 4, // Detail: number of locks
+    commit    = 5,
+    abort_    = 6  // Detail: abort reason
+};
+
+/** Get the name of an abort reason.
+ * @param reason Abort reason
+ * @return Constant null-terminated name
+**/
+static char const* reason_name(uint16_t reason) {
+    char const* const names[] = {"none", "read locked", "read version", "commit locked", "commit validation", "out of memory", "invalid operation"};
+    return reason < sizeof(names) / sizeof(*names) ? names[reason] : "unknown";
+}
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "tracejson") << " <trace file> <JSON output file>" << ::std::endl;
+        return 1;
+    }
+    ::std::ifstream input{argv[1], ::std::ios::binary};
+    char magic[8];
+    double ticks_per_us;
+    uint32_t nbthreads, zero;
+    if (!input.read(magic, sizeof(magic)) || ::std::memcmp(magic, "TMTRACE1", sizeof(magic)) != 0
+     || !input.read(reinterpret_cast<char*>(&ticks_per_us), sizeof(ticks_per_us))
+     || !input.read(reinterpret_cast<char*>(&nbthreads), sizeof(nbthreads)) || !input.read(reinterpret_cast<char*>(&zero), sizeof(zero))) {
+        ::std::cerr << "'" << argv[1] << "' is not an event trace" << ::std::endl;
+        return 1;
+    }
+    // Read every thread first, for the common time origin
+    struct Thread {
+        uint32_t index;
+        uint64_t lost;
+        ::std::vector<Event> events;
+    };
+    ::std::vector<Thread> threads(nbthreads);
+    auto origin = UINT64_MAX;
+    for (auto&& thread: threads) {
+        uint32_t count;
+        if (!input.read(reinterpret_cast<char*>(&thread.index), sizeof(thread.index)) || !input.read(reinterpret_cast<char*>(&count), sizeof(count))
+         || !input.read(reinterpret_cast<char*>(&thread.lost), sizeof(thread.lost))) {
+            ::std::cerr << "'" << argv[1] << "' is truncated" << ::std::endl;
+            return 1;
+        }
+        thread.events.resize(count);
+        if (count > 0 && !input.read(reinterpret_cast<char*>(thread.events.data()), count * sizeof(Event))) {
+            ::std::cerr << "'" << argv[1] << "' is truncated" << ::std::endl;
+            return 1;
+        }
+        if (count > 0 && thread.events.front().tsc < origin)
+            origin = thread.events.front().tsc;
+    }
+    auto output = ::std::fopen(argv[2], "w");
+    if (!output) {
+        ::std::cerr << "Unable to open '" << argv[2] << "'" << ::std::endl;
+        return 1;
+    }
+    // Slices must nest: events of a transaction whose beginning was overwritten are skipped
+    ::std::fprintf(output, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    auto first = true;
+    auto emit = [&](char const* phase, char const* name, uint32_t tid, uint64_t tsc, uint32_t tx, char const* detail) {
+        ::std::fprintf(output, "%s{\"ph\":\"%s\",\"name\":\"%s\",\"pid\":0,\"tid\":%u,\"ts\":%.3f%s,\"args\":{\"tx\":%u%s%s%s}}", first ? "" : ",\n", phase, name, tid, (tsc - origin) / ticks_per_us,
+                       phase[0] == 'i' ? ",\"s\":\"t\"" : "", tx, detail ? ",\"detail\":\"" : "", detail ? detail : "", detail ? "\"" : "");
+        first = false;
+    };
+    uint64_t nbevents = 0, nblost = 0;
+    for (auto&& thread: threads) {
+        auto in_tx = false;
+        auto in_lock = false;
+        for (auto&& event: thread.events) {
+            switch (event.type) {
+                case begin:
+                    if (in_lock)
+                        emit("E", "locking", thread.index, event.tsc, event.tx, nullptr);
+                    if (in_tx)
+                        emit("E", "tx", thread.index, event.tsc, event.tx, nullptr);
+                    emit("B", "tx", thread.index, event.tsc, event.tx, event.detail ? "read-only" : "read-write");
+                    in_tx = true;
+                    in_lock = false;
+                    break;
+                case read_fail:
+                    if (in_tx)
+                        emit("i", "read validation failed", thread.index, event.tsc, event.tx, reason_name(event.detail));
+                    break;
+                case lock:
+                    if (in_tx && !in_lock) {
+                        emit("B", "locking", thread.index, event.tsc, event.tx, nullptr);
+                        in_lock = true;
+                    }
+                    break;
+                case locked:
+                    if (in_lock) {
+                        char locks[16];
+                        ::std::snprintf(locks, sizeof(locks), "%u locks", event.detail);
+                        emit("E", "locking", thread.index, event.tsc, event.tx, locks);
+                        in_lock = false;
+                    }
+                    break;
+                case commit:
+                case abort_:
+                    if (!in_tx)
+                        break;
+                    if (in_lock)
+                        emit("E", "locking", thread.index, event.tsc, event.tx, nullptr);
+                    if (event.type == abort_)
+                        emit("i", "abort", thread.index, event.tsc, event.tx, reason_name(event.detail));
+                    emit("E", "tx", thread.index, event.tsc, event.tx, event.type == commit ? "commit" : "abort");
+                    in_tx = false;
+                    in_lock = false;
+                    break;
+            }
+        }
+        nbevents += thread.events.size();
+        nblost += thread.lost;
+    }
+    ::std::fprintf(output, "\n]}\n");
+    if (::std::fclose(output) != 0) {
+        ::std::cerr << "Unable to write '" << argv[2] << "'" << ::std::endl;
+        return 1;
+    }
+    ::std::cout << nbthreads << " threads, " << nbevents << " events (" << nblost << " overwritten), " << ticks_per_us << " ticks/us" << ::std::endl;
+    return 0;
+}
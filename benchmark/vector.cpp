@@ -0,0 +1,124 @@
+/**
+ * @file   vector.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Per-element cost of transactions accessing random words, one 'tm_read'/'tm_write' per element or one 'tm_readv'/'tm_writev' per transaction, as the vector length grows.
+**/
+
+// External headers
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Internal headers
+#include "bench.hpp"
+#include "common.hpp"
+#include "transactional.hpp"
+
+// -------------------------------------------------------------------------- //
+
+using Word = uintptr_t;
+
+/** Program entry point.
+ * @param argc Arguments count
+ * @param argv Arguments values
+ * @return Program return code
+**/
+int main(int argc, char** argv) {
+    try {
+        // Parse command line option(s)
+        auto nbthreads = default_nbthreads();
+        auto nbtxs     = 100000ul;
+        auto nbwords   = size_t{1} << 20;
+        auto maxlength = 64ul;
+        while (argc > 2 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--threads") == 0) {
+                nbthreads = static_cast<unsigned int>(::std::stoul(argv[2]));
+            } else if (::std::strcmp(argv[1], "--txs") == 0) {
+                nbtxs = ::std::stoul(argv[2]);
+            } else if (::std::strcmp(argv[1], "--words") == 0) {
+                nbwords = parse_size(argv[2]);
+            } else if (::std::strcmp(argv[1], "--max-length") == 0) {
+                maxlength = ::std::stoul(argv[2]);
+            } else {
+                break;
+            }
+            { // Pop the option and its value
+                argv[2] = argv[0];
+                argc -= 2;
+                argv += 2;
+            }
+        }
+        if (argc != 2 || nbthreads == 0 || nbwords == 0 || maxlength == 0) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "vector") << " [--threads <n>] [--txs <per thread>] [--words <region size in words>] [--max-length <elements>] <library path>" << ::std::endl;
+            return 1;
+        }
+        TransactionalLibrary tl{argv[1]};
+        TransactionalMemory tm{tl, sizeof(Word), nbwords * sizeof(Word)};
+        auto const base = static_cast<Word*>(tm.get_start());
+        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) { // Fault the region in before measuring
+            ::std::vector<Word> zeros(nbwords);
+            tx.write_range(zeros.data(), nbwords * sizeof(Word), base);
+        });
+        ::std::printf("%8s %10s %16s %16s %16s %16s\n", "length", "mode", "scalar (ns/el)", "vector (ns/el)", "scalar (tx/s)", "vector (tx/s)");
+        for (auto length = 1ul; length <= maxlength; length *= 2) {
+            for (auto mode: {Transaction::Mode::read_only, Transaction::Mode::read_write}) {
+                Chrono::Tick ticks[2];
+                for (auto vector: {false, true}) {
+                    ticks[vector] = run_threads(nbthreads, [&](unsigned int id) {
+                        Random random{id + 1};
+                        ::std::vector<Word> values(length);
+                        ::std::vector<STM::tm_vec> vecs(length);
+                        for (size_t i = 0; i < nbtxs; ++i) {
+                            for (size_t j = 0; j < length; ++j)
+                                vecs[j] = STM::tm_vec{base + random(nbwords), &values[j], sizeof(Word)};
+                            transactional(tm, mode, [&](Transaction& tx) {
+                                if (vector) {
+                                    tx.readv(vecs.data(), length);
+                                } else {
+                                    for (auto&& vec: vecs)
+                                        tx.read(vec.shared, vec.size, vec.local);
+                                }
+                                if (mode == Transaction::Mode::read_only)
+                                    return;
+                                for (auto&& value: values)
+                                    ++value;
+                                if (vector) {
+                                    tx.writev(vecs.data(), length);
+                                } else {
+                                    for (auto&& vec: vecs)
+                                        tx.write(vec.local, vec.size, vec.shared);
+                                }
+                            });
+                        }
+                    });
+                }
+                auto const elements = static_cast<double>(nbtxs) * nbthreads * length;
+                auto const txs = static_cast<double>(nbtxs) * nbthreads;
+                ::std::printf("%8lu %10s %16.2f %16.2f %16.0f %16.0f\n", length, mode == Transaction::Mode::read_only ? "read-only" : "read-write", ticks[0] / elements, ticks[1] / elements, txs / (ticks[0] / 1e9), txs / (ticks[1] / 1e9));
+                ::std::fflush(stdout);
+            }
+        }
+        return 0;
+    } catch (::std::exception const& err) {
+        ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file   allocator.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Allocator policies, providing zero-initialized memory for the shared segments and the lock table.
+**/
+
+#pragma once
+
+// External headers
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+extern "C" {
+#include <sys/mman.h>
+#include <unistd.h>
+}
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+namespace Allocator {
+
+/** Heap allocator, eagerly zeroing the allocated memory.
+**/
+class Heap final {
+public:
+    /** Get the largest supported alignment.
+     * @return Largest alignment (in bytes)
+    **/
+    static size_t max_align() noexcept {
+        return SIZE_MAX;
+    }
+    /** Allocate zero-initialized memory.
+     * @param size  Size to allocate (in bytes)
+     * @param align Required alignment (in bytes, power of 2)
+     * @return Allocated memory, 'nullptr' on failure
+    **/
+    static void* allocate(size_t size, size_t align) noexcept {
+        if (align < sizeof(void*))
+            align = sizeof(void*);
+        void* res;
+        if (unlikely(::posix_memalign(&res, align, size) != 0))
+            return nullptr;
+        ::std::memset(res, 0, size);
+        return res;
+    }
+    /** Release memory that is no longer reachable by any transaction.
+     * @param ptr  Allocated memory
+     * @param size Size of the allocation (in bytes)
+    **/
+    static void release(void* ptr, size_t size [[gnu::unused]]) noexcept {
+        ::free(ptr);
+    }
+};
+
+/** Anonymous memory mapping allocator, lazily zeroed by the kernel.
+**/
+class Mmap final {
+public:
+    /** Get the largest supported alignment, the one of the mappings.
+     * @return Largest alignment (in bytes)
+    **/
+    static size_t max_align() noexcept {
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    }
+    /** Allocate zero-initialized memory.
+     * @param size  Size to allocate (in bytes)
+     * @param align Required alignment (in bytes, power of 2, at most 'max_align()')
+     * @return Allocated memory, 'nullptr' on failure
+    **/
+    static void* allocate(size_t size, size_t align [[gnu::unused]]) noexcept {
+        auto res = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (unlikely(res == MAP_FAILED))
+            return nullptr;
+        return res;
+    }
+    /** Release memory that is no longer reachable by any transaction.
+     * @param ptr  Allocated memory
+     * @param size Size of the allocation (in bytes)
+    **/
+    static void release(void* ptr, size_t size) noexcept {
+        ::munmap(ptr, size);
+    }
+};
+
+}
+}
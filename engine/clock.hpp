@@ -0,0 +1,99 @@
+/**
+ * @file   clock.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Global version clock policies.
+**/
+
+#pragma once
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+namespace Clock {
+
+/** Fetch-and-increment global version clock (TL2's GV1).
+**/
+class GV1 final: private NonCopyable {
+private:
+    alignas(cache_line) ::std::atomic<Word> value; // Current clock value
+    char padding[cache_line - sizeof(value)]; // Avoid false sharing with the following members
+public:
+    /** Zero-initialization constructor.
+    **/
+    GV1() noexcept: value{0} {}
+public:
+    /** [thread-safe] Sample the clock, at transaction begin.
+     * @return Read version
+    **/
+    Word sample() const noexcept {
+        return value.load(::std::memory_order_acquire);
+    }
+    /** [thread-safe] Get a commit timestamp, once every written stripe has been locked.
+     * @param rv Read version of the committing transaction
+     * @param wv Write version (output)
+     * @return Whether no other transaction committed since 'rv', i.e. the read-set validation can be skipped
+    **/
+    bool commit(Word rv, Word& wv) noexcept {
+        auto prev = value.fetch_add(1, ::std::memory_order_acq_rel);
+        wv = prev + 1;
+        return prev == rv;
+    }
+};
+
+/** Compare-and-swap global version clock, where a failed increment reuses the winner's timestamp (TL2's GV4).
+ *
+ * Sharing a timestamp is safe because the loser's expected value is sampled after all of its write locks were
+ * taken, so any transaction reading the shared timestamp as its read version started after those locks were held.
+**/
+class GV4 final: private NonCopyable {
+private:
+    alignas(cache_line) ::std::atomic<Word> value; // Current clock value
+    char padding[cache_line - sizeof(value)]; // Avoid false sharing with the following members
+public:
+    /** Zero-initialization constructor.
+    **/
+    GV4() noexcept: value{0} {}
+public:
+    /** [thread-safe] Sample the clock, at transaction begin.
+     * @return Read version
+    **/
+    Word sample() const noexcept {
+        return value.load(::std::memory_order_acquire);
+    }
+    /** [thread-safe] Get a commit timestamp, once every written stripe has been locked.
+     * @param rv Read version of the committing transaction
+     * @param wv Write version (output)
+     * @return Whether no other transaction committed since 'rv', i.e. the read-set validation can be skipped
+    **/
+    bool commit(Word rv, Word& wv) noexcept {
+        auto cur = value.load(::std::memory_order_acquire);
+        if (likely(value.compare_exchange_strong(cur, cur + 1, ::std::memory_order_acq_rel, ::std::memory_order_acquire))) {
+            wv = cur + 1;
+            return cur == rv;
+        }
+        wv = cur; // Value set by the winner
+        return false;
+    }
+};
+
+}
+}
@@ -0,0 +1,166 @@
+/**
+ * @file   common.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Common definitions shared by the policy-based transaction manager and its policies.
+**/
+
+#pragma once
+
+// Compile-time configuration
+// #define USE_MM_PAUSE
+
+// External headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#if (defined(__i386__) || defined(__x86_64__)) && defined(USE_MM_PAUSE)
+    #include <xmmintrin.h>
+#endif
+
+// -------------------------------------------------------------------------- //
+
+/** Define a proposition as likely true.
+ * @param prop Proposition
+**/
+#undef likely
+#ifdef __GNUC__
+    #define likely(prop) \
+        __builtin_expect((prop) ? 1 : 0, 1)
+#else
+    #define likely(prop) \
+        (prop)
+#endif
+
+/** Define a proposition as likely false.
+ * @param prop Proposition
+**/
+#undef unlikely
+#ifdef __GNUC__
+    #define unlikely(prop) \
+        __builtin_expect((prop) ? 1 : 0, 0)
+#else
+    #define unlikely(prop) \
+        (prop)
+#endif
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+
+/** Machine word, used for versioned locks and timestamps.
+**/
+using Word = uintptr_t;
+
+/** Assumed cache line size (in bytes).
+**/
+constexpr static size_t cache_line = 64;
+
+/** Non-copyable helper base class.
+**/
+class NonCopyable {
+public:
+    /** Deleted copy constructor/assignment.
+    **/
+    NonCopyable(NonCopyable const&) = delete;
+    NonCopyable& operator=(NonCopyable const&) = delete;
+protected:
+    /** Protected default constructor, to make sure class is not directly instantiated.
+    **/
+    NonCopyable() = default;
+};
+
+/** Pause for a very short amount of time.
+**/
+static inline void pause() noexcept {
+#if (defined(__i386__) || defined(__x86_64__)) && defined(USE_MM_PAUSE)
+    _mm_pause();
+#else
+    ::std::this_thread::yield();
+#endif
+}
+
+/** Relax the processor inside a busy-waiting loop, without yielding.
+**/
+static inline void relax() noexcept {
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+    __builtin_ia32_pause();
+#else
+    ::std::atomic_signal_fence(::std::memory_order_seq_cst);
+#endif
+}
+
+/** Versioned lock, either holding a version number or the address of its owner.
+**/
+class VersionedLock final: private NonCopyable {
+private:
+    ::std::atomic<Word> word; // Even: version number (shifted by 1), odd: owner address (tagged)
+public:
+    /** Check whether the given lock word denotes a locked state.
+     * @param word Lock word
+     * @return Whether the lock was taken
+    **/
+    constexpr static bool is_locked(Word word) noexcept {
+        return (word & 1) != 0;
+    }
+    /** Get the version number of the given unlocked lock word.
+     * @param word Unlocked lock word
+     * @return Version number
+    **/
+    constexpr static Word version(Word word) noexcept {
+        return word >> 1;
+    }
+    /** Build the unlocked lock word corresponding to the given version.
+     * @param version Version number
+     * @return Unlocked lock word
+    **/
+    constexpr static Word make_version(Word version) noexcept {
+        return version << 1;
+    }
+    /** Build the locked lock word corresponding to the given owner.
+     * @param owner Owner address (at least 2-byte aligned)
+     * @return Locked lock word
+    **/
+    static Word make_owner(void const* owner) noexcept {
+        return reinterpret_cast<Word>(owner) | 1;
+    }
+public:
+    /** Sample the lock word.
+     * @return Current lock word
+    **/
+    Word load() const noexcept {
+        return word.load(::std::memory_order_acquire);
+    }
+    /** Try to lock, expecting the given (unlocked) lock word.
+     * @param expected Expected unlocked lock word
+     * @param owner    Owner address
+     * @return Whether the lock was acquired
+    **/
+    bool try_lock(Word expected, void const* owner) noexcept {
+        return word.compare_exchange_strong(expected, make_owner(owner), ::std::memory_order_acquire, ::std::memory_order_relaxed);
+    }
+    /** Release the lock, storing the given (unlocked) lock word.
+     * @param unlocked Unlocked lock word to store
+    **/
+    void unlock(Word unlocked) noexcept {
+        word.store(unlocked, ::std::memory_order_release);
+    }
+};
+
+}
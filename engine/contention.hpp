@@ -0,0 +1,141 @@
+/**
+ * @file   contention.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Contention manager policies, deciding how to react to a busy lock and to an abort.
+**/
+
+#pragma once
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+namespace Contention {
+
+/** Abort as soon as a conflict is detected, retry immediately.
+**/
+class Suicide final {
+public:
+    /** Per-thread state.
+    **/
+    struct State {};
+public:
+    /** A lock to acquire is held by another transaction.
+     * @param state   Per-thread state
+     * @param attempt Number of failed attempts on this lock so far
+     * @return Whether to wait and retry, abort otherwise
+    **/
+    static bool on_busy(State& state [[gnu::unused]], unsigned int attempt [[gnu::unused]]) noexcept {
+        return false;
+    }
+    /** The transaction aborted.
+     * @param state Per-thread state
+    **/
+    static void on_abort(State& state [[gnu::unused]]) noexcept {}
+    /** The transaction committed.
+     * @param state Per-thread state
+    **/
+    static void on_commit(State& state [[gnu::unused]]) noexcept {}
+};
+
+/** Wait a bounded number of pauses on a busy lock, then abort and retry immediately.
+ * @param Spins Maximum number of pauses on a busy lock
+**/
+template<unsigned int Spins = 64> class Spin final {
+public:
+    /** Per-thread state.
+    **/
+    struct State {};
+public:
+    /** A lock to acquire is held by another transaction.
+     * @param state   Per-thread state
+     * @param attempt Number of failed attempts on this lock so far
+     * @return Whether to wait and retry, abort otherwise
+    **/
+    static bool on_busy(State& state [[gnu::unused]], unsigned int attempt) noexcept {
+        if (attempt >= Spins)
+            return false;
+        relax();
+        return true;
+    }
+    /** The transaction aborted.
+     * @param state Per-thread state
+    **/
+    static void on_abort(State& state [[gnu::unused]]) noexcept {}
+    /** The transaction committed.
+     * @param state Per-thread state
+    **/
+    static void on_commit(State& state [[gnu::unused]]) noexcept {}
+};
+
+/** Wait a bounded number of pauses on a busy lock, then abort and wait for a randomized, exponentially growing delay.
+ * @param MinLog Base-2 logarithm of the maximum delay after the first abort (in pauses)
+ * @param MaxLog Base-2 logarithm of the maximum delay (in pauses)
+ * @param Spins  Maximum number of pauses on a busy lock
+**/
+template<unsigned int MinLog = 4, unsigned int MaxLog = 16, unsigned int Spins = 16> class Backoff final {
+    static_assert(MinLog <= MaxLog && MaxLog < 32, "Invalid backoff bounds");
+public:
+    /** Per-thread state.
+    **/
+    struct State {
+        uint32_t     seed   = 0x9e3779b9u; // Pseudo-random generator state
+        unsigned int aborts = 0; // Number of consecutive aborts
+    };
+public:
+    /** A lock to acquire is held by another transaction.
+     * @param state   Per-thread state
+     * @param attempt Number of failed attempts on this lock so far
+     * @return Whether to wait and retry, abort otherwise
+    **/
+    static bool on_busy(State& state [[gnu::unused]], unsigned int attempt) noexcept {
+        if (attempt >= Spins)
+            return false;
+        relax();
+        return true;
+    }
+    /** The transaction aborted.
+     * @param state Per-thread state
+    **/
+    static void on_abort(State& state) noexcept {
+        auto log = MinLog + state.aborts;
+        if (log > MaxLog) {
+            log = MaxLog;
+        } else {
+            ++state.aborts;
+        }
+        // Xorshift32
+        state.seed ^= state.seed << 13;
+        state.seed ^= state.seed >> 17;
+        state.seed ^= state.seed << 5;
+        for (auto delay = state.seed & ((uint32_t{1} << log) - 1); delay > 0; --delay)
+            relax();
+    }
+    /** The transaction committed.
+     * @param state Per-thread state
+    **/
+    static void on_commit(State& state) noexcept {
+        state.aborts = 0;
+    }
+};
+
+}
+}
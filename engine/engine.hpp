@@ -0,0 +1,565 @@
+/**
+ * @file   engine.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Transaction manager composed at compile-time from policies (clock, lock table, read log, write log, contention manager and allocator).
+ *
+ * A variant is a 'using' declaration of 'Engine::Manager<...>' followed by 'ENGINE_EXPORT(variant)', which defines
+ * the 'tm_*' functions of 'tm.hpp' with every policy call inlined. See the 'variants' directory.
+**/
+
+#pragma once
+
+// External headers
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Internal headers
+#pragma GCC visibility push(default)
+#include <tm.hpp>
+#pragma GCC visibility pop
+#include "common.hpp"
+#include "allocator.hpp"
+#include "clock.hpp"
+#include "contention.hpp"
+#include "locktable.hpp"
+#include "readlog.hpp"
+#include "writelog.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+
+/** Word-based, redo-logging, time-based transaction manager (TL2 family), composed from policies.
+ * @param Clock      Global version clock policy (see 'clock.hpp')
+ * @param LockTable  Lock table policy (see 'locktable.hpp')
+ * @param ReadLog    Read log policy (see 'readlog.hpp')
+ * @param WriteLog   Write log policy (see 'writelog.hpp')
+ * @param Contention Contention manager policy (see 'contention.hpp')
+ * @param Allocator  Allocator policy (see 'allocator.hpp')
+**/
+template<class Clock, class LockTable, class ReadLog, class WriteLog, class Contention, class Allocator> class Manager final {
+private:
+    /** Header of a segment allocated with 'tm_alloc'.
+    **/
+    struct Segment {
+        Segment* prev; // Previous segment in the chain
+        Segment* next; // Next segment in the chain
+        size_t   size; // Size of the segment, excluding this header (in bytes)
+    };
+    /** Shared memory region.
+    **/
+    class Region final: private NonCopyable {
+    public:
+        Clock      clock;       // Global version clock
+        LockTable  locks;       // Lock table
+        void*      start;       // Start of the first segment
+        size_t     size;        // Size of the first segment (in bytes)
+        size_t     align;       // Claimed alignment of the region (in bytes)
+        size_t     align_alloc; // Actual alignment of the segment allocations (in bytes)
+        size_t     delta_alloc; // Space to add at the beginning of an allocation for the segment header (in bytes)
+        ::std::mutex segments_lock; // Segment chain and limbo lock
+        Segment      segments;      // Segment chain sentinel
+        ::std::vector<::std::pair<Segment*, Word>> limbo; // Freed segments still chained, with the write version that freed them
+    public:
+        /** Default constructor.
+        **/
+        Region(): start{nullptr} {
+            segments.prev = &segments;
+            segments.next = &segments;
+        }
+    };
+    class Transaction;
+    /** Registry of the transaction descriptors of every thread, scanned before releasing freed segments.
+    **/
+    struct Registry final {
+        ::std::mutex lock;          // Descriptor list lock
+        Transaction* head{nullptr}; // First registered descriptor
+    };
+    /** Get the descriptor registry.
+     * @return Descriptor registry
+    **/
+    static Registry& registry() noexcept {
+        static Registry reg;
+        return reg;
+    }
+    /** Per-thread transaction descriptor, reused by every transaction of the thread.
+    **/
+    class Transaction final: private NonCopyable {
+    public:
+        ::std::atomic<Region*> active_region{nullptr}; // Region of the running transaction, 'nullptr' if none
+        ::std::atomic<Word>    active_rv{0};           // Read version of the running transaction, if any
+        Transaction* prev; // Previous registered descriptor
+        Transaction* next; // Next registered descriptor
+        Region*  region; // Region the transaction runs on
+        Word     rv;     // Read version
+        bool     is_ro;  // Whether the transaction is read-only
+        ReadLog  reads;  // Read log
+        WriteLog writes; // Write log
+        ::std::vector<::std::pair<VersionedLock*, Word>> locked; // Acquired locks, with their previous lock word
+        ::std::vector<Segment*> allocated; // Segments allocated by the transaction
+        ::std::vector<Segment*> freed;     // Segments freed by the transaction
+        typename Contention::State cm;     // Contention manager state
+    public:
+        /** Register constructor.
+        **/
+        Transaction() {
+            auto& reg = registry();
+            ::std::unique_lock<decltype(reg.lock)> guard{reg.lock};
+            prev = nullptr;
+            next = reg.head;
+            if (next)
+                next->prev = this;
+            reg.head = this;
+        }
+        /** Unregister destructor.
+        **/
+        ~Transaction() {
+            auto& reg = registry();
+            ::std::unique_lock<decltype(reg.lock)> guard{reg.lock};
+            if (prev)
+                prev->next = next;
+            else
+                reg.head = next;
+            if (next)
+                next->prev = prev;
+        }
+    };
+private:
+    /** Get the transaction descriptor of the calling thread.
+     * @return Transaction descriptor
+    **/
+    static Transaction& local() noexcept {
+        static thread_local Transaction tx;
+        return tx;
+    }
+    /** Get the segment header of the given allocated segment.
+     * @param region Region the segment belongs to
+     * @param addr   Start address of the segment
+     * @return Segment header
+    **/
+    static Segment* segment_of(Region& region, void* addr) noexcept {
+        return reinterpret_cast<Segment*>(reinterpret_cast<uintptr_t>(addr) - region.delta_alloc);
+    }
+    /** Get the start address of the given allocated segment.
+     * @param region  Region the segment belongs to
+     * @param segment Segment header
+     * @return Start address of the segment
+    **/
+    static void* data_of(Region& region, Segment* segment) noexcept {
+        return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(segment) + region.delta_alloc);
+    }
+    /** Acquire the given lock on behalf of the given transaction.
+     * @param tx   Transaction
+     * @param lock Lock to acquire
+     * @return Whether the lock is held by the transaction (not if it could not be recorded)
+    **/
+    static bool acquire(Transaction& tx, VersionedLock& lock) noexcept {
+        for (unsigned int attempt = 0;; ++attempt) {
+            auto word = lock.load();
+            if (VersionedLock::is_locked(word)) {
+                if (word == VersionedLock::make_owner(&tx)) // Already owned (or aliased stripe)
+                    return true;
+                if (!Contention::on_busy(tx.cm, attempt))
+                    return false;
+                continue;
+            }
+            if (unlikely(VersionedLock::version(word) > tx.rv)) // Stripe may have been read with an older version
+                return false;
+            if (likely(lock.try_lock(word, &tx))) {
+                try {
+                    tx.locked.emplace_back(&lock, word);
+                } catch (::std::bad_alloc const&) { // Would not be released on abort
+                    lock.unlock(word);
+                    return false;
+                }
+                return true;
+            }
+        }
+    }
+    /** Abort the given transaction, releasing every resource it holds.
+     * @param tx Transaction to abort
+    **/
+    static void abort(Transaction& tx) noexcept {
+        tx.active_region.store(nullptr, ::std::memory_order_release);
+        for (auto&& entry: tx.locked)
+            entry.first->unlock(entry.second);
+        tx.locked.clear();
+        if (!tx.allocated.empty()) { // Never published, can be released right away
+            auto& region = *tx.region;
+            ::std::unique_lock<decltype(region.segments_lock)> guard{region.segments_lock};
+            for (auto segment: tx.allocated) {
+                segment->prev->next = segment->next;
+                segment->next->prev = segment->prev;
+                Allocator::release(segment, region.delta_alloc + segment->size);
+            }
+        }
+        tx.allocated.clear();
+        tx.freed.clear();
+        Contention::on_abort(tx.cm);
+    }
+    /** Get the oldest read version among the transactions running on the given region.
+     * @param region Region to consider
+     * @return Oldest read version, the largest version if none
+    **/
+    static Word oldest_rv(Region& region) noexcept {
+        auto& reg = registry();
+        auto res = ~Word{0};
+        ::std::unique_lock<decltype(reg.lock)> guard{reg.lock};
+        for (auto tx = reg.head; tx; tx = tx->next) {
+            if (tx->active_region.load(::std::memory_order_acquire) != &region)
+                continue;
+            auto rv = tx->active_rv.load(::std::memory_order_relaxed);
+            if (rv < res)
+                res = rv;
+        }
+        return res;
+    }
+    /** Retire the segments freed by the given committed transaction, then release every retired segment of the region
+     * that no running transaction can still read.
+     * @param tx Committed transaction, no longer running
+     * @param wv Write version of the transaction
+    **/
+    static void retire(Transaction& tx, Word wv) noexcept {
+        auto& region = *tx.region;
+        ::std::unique_lock<decltype(region.segments_lock)> guard{region.segments_lock};
+        for (auto segment: tx.freed) {
+            try {
+                region.limbo.emplace_back(segment, wv);
+            } catch (::std::bad_alloc const&) { // Left chained, released by 'tm_destroy'
+                break;
+            }
+        }
+        tx.freed.clear();
+        // A transaction that publishes its read version after this fence only accesses memory after the freeing commit,
+        // where the segment is unreachable; one that did before must have a read version newer than 'wv' (equal ones may
+        // predate the commit, as clocks like 'GV4' share versions)
+        ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+        auto oldest = oldest_rv(region);
+        auto kept = region.limbo.begin();
+        for (auto&& entry: region.limbo) {
+            auto segment = entry.first;
+            if (entry.second >= oldest) { // May still be read by a doomed transaction
+                *(kept++) = entry;
+                continue;
+            }
+            segment->prev->next = segment->next;
+            segment->next->prev = segment->prev;
+            Allocator::release(segment, region.delta_alloc + segment->size);
+        }
+        region.limbo.erase(kept, region.limbo.end());
+    }
+public:
+    /** Create (i.e. allocate + init) a new shared memory region, with one first non-free-able allocated segment of the requested size and alignment.
+     * @param size  Size of the first shared segment of memory to allocate (in bytes), must be a positive multiple of the alignment
+     * @param align Alignment (in bytes, must be a power of 2) that the shared memory region must support
+     * @return Opaque shared memory region handle, 'invalid_shared' on failure
+    **/
+    static shared_t create(size_t size, size_t align) noexcept {
+        auto region = new (::std::nothrow) Region{};
+        if (unlikely(!region))
+            return invalid_shared;
+        if (unlikely(!region->locks.template init<Allocator>())) {
+            delete region;
+            return invalid_shared;
+        }
+        auto align_alloc = align < sizeof(void*) ? sizeof(void*) : align; // Also satisfy alignment requirement of 'Segment'
+        if (unlikely(align_alloc > Allocator::max_align())) {
+            region->locks.template fini<Allocator>();
+            delete region;
+            return invalid_shared;
+        }
+        region->start = Allocator::allocate(size, align_alloc);
+        if (unlikely(!region->start)) {
+            region->locks.template fini<Allocator>();
+            delete region;
+            return invalid_shared;
+        }
+        region->size        = size;
+        region->align       = align;
+        region->align_alloc = align_alloc;
+        region->delta_alloc = (sizeof(Segment) + align_alloc - 1) / align_alloc * align_alloc;
+        return region;
+    }
+    /** Destroy (i.e. clean-up + free) a given shared memory region.
+     * @param shared Shared memory region to destroy, with no running transaction
+    **/
+    static void destroy(shared_t shared) noexcept {
+        auto region = reinterpret_cast<Region*>(shared);
+        auto sentinel = &(region->segments);
+        for (auto segment = sentinel->next; segment != sentinel;) {
+            auto next = segment->next;
+            Allocator::release(segment, region->delta_alloc + segment->size);
+            segment = next;
+        }
+        Allocator::release(region->start, region->size);
+        region->locks.template fini<Allocator>();
+        delete region;
+    }
+    /** [thread-safe] Return the start address of the first allocated segment in the shared memory region.
+     * @param shared Shared memory region to query
+     * @return Start address of the first allocated segment
+    **/
+    static void* start(shared_t shared) noexcept {
+        return reinterpret_cast<Region*>(shared)->start;
+    }
+    /** [thread-safe] Return the size (in bytes) of the first allocated segment of the shared memory region.
+     * @param shared Shared memory region to query
+     * @return First allocated segment size
+    **/
+    static size_t size(shared_t shared) noexcept {
+        return reinterpret_cast<Region*>(shared)->size;
+    }
+    /** [thread-safe] Return the alignment (in bytes) of the memory accesses on the given shared memory region.
+     * @param shared Shared memory region to query
+     * @return Alignment used globally
+    **/
+    static size_t align(shared_t shared) noexcept {
+        return reinterpret_cast<Region*>(shared)->align;
+    }
+    /** [thread-safe] Begin a new transaction on the given shared memory region.
+     * @param shared Shared memory region to start a transaction on
+     * @param is_ro  Whether the transaction is read-only
+     * @return Opaque transaction ID, 'invalid_tx' on failure
+    **/
+    static tx_t begin(shared_t shared, bool is_ro) noexcept {
+        auto& tx = local();
+        tx.region = reinterpret_cast<Region*>(shared);
+        tx.is_ro  = is_ro;
+        tx.reads.clear();
+        tx.writes.clear();
+        tx.locked.clear();
+        tx.allocated.clear();
+        tx.freed.clear();
+        auto rv = tx.region->clock.sample();
+        tx.active_rv.store(rv, ::std::memory_order_relaxed);
+        tx.active_region.store(tx.region, ::std::memory_order_release);
+        ::std::atomic_thread_fence(::std::memory_order_seq_cst); // Published before any access (see 'retire')
+        tx.rv = rv;
+        return reinterpret_cast<tx_t>(&tx);
+    }
+    /** [thread-safe] End the given transaction.
+     * @param shared Shared memory region associated with the transaction
+     * @param txid   Transaction to end
+     * @return Whether the whole transaction committed
+    **/
+    static bool end(shared_t shared [[gnu::unused]], tx_t txid) noexcept {
+        auto& tx = *reinterpret_cast<Transaction*>(txid);
+        auto& region = *tx.region;
+        if (tx.writes.empty() && tx.freed.empty()) { // Every read was consistent with the read version
+            tx.active_region.store(nullptr, ::std::memory_order_release);
+            Contention::on_commit(tx.cm);
+            return true;
+        }
+        { // Lock the freed stripes, so that their new version dooms the transactions that could still read them
+            auto locked = true;
+            for (auto segment: tx.freed) {
+                locked = region.locks.for_each(data_of(region, segment), segment->size, [&](VersionedLock& lock, void*, size_t) {
+                    return acquire(tx, lock);
+                });
+                if (unlikely(!locked))
+                    break;
+            }
+            if (unlikely(!locked)) {
+                abort(tx);
+                return false;
+            }
+        }
+        if (!WriteLog::encounter_time) { // Lock the written stripes
+            auto locked = tx.writes.all([&](void* target, size_t size) {
+                return region.locks.for_each(target, size, [&](VersionedLock& lock, void*, size_t) {
+                    return acquire(tx, lock);
+                });
+            });
+            if (unlikely(!locked)) {
+                abort(tx);
+                return false;
+            }
+        }
+        Word wv;
+        if (!region.clock.commit(tx.rv, wv)) { // Validate the read set
+            auto owner = VersionedLock::make_owner(&tx);
+            auto valid = tx.reads.all([&](VersionedLock const& lock) {
+                auto word = lock.load();
+                if (VersionedLock::is_locked(word))
+                    return word == owner; // Owned locks had a version no greater than 'rv' when acquired
+                return VersionedLock::version(word) <= tx.rv;
+            });
+            if (unlikely(!valid)) {
+                abort(tx);
+                return false;
+            }
+        }
+        tx.writes.write_back();
+        auto unlocked = VersionedLock::make_version(wv);
+        for (auto&& entry: tx.locked)
+            entry.first->unlock(unlocked);
+        tx.locked.clear();
+        tx.active_region.store(nullptr, ::std::memory_order_release);
+        if (!tx.freed.empty())
+            retire(tx, wv);
+        Contention::on_commit(tx.cm);
+        return true;
+    }
+    /** [thread-safe] Read operation in the given transaction, source in the shared region and target in a private region.
+     * @param shared Shared memory region associated with the transaction
+     * @param txid   Transaction to use
+     * @param source Source start address (in the shared region)
+     * @param size   Length to copy (in bytes), must be a positive multiple of the alignment
+     * @param target Target start address (in a private region)
+     * @return Whether the whole transaction can continue
+    **/
+    static bool read(shared_t shared [[gnu::unused]], tx_t txid, void const* source, size_t size, void* target) noexcept {
+        auto& tx = *reinterpret_cast<Transaction*>(txid);
+        auto owner = VersionedLock::make_owner(&tx);
+        auto valid = tx.region->locks.for_each(source, size, [&](VersionedLock& lock, void* chunk, size_t len) {
+            auto dest = reinterpret_cast<char*>(target) + (reinterpret_cast<uintptr_t>(chunk) - reinterpret_cast<uintptr_t>(source));
+            for (unsigned int attempt = 0;; ++attempt) {
+                auto before = lock.load();
+                if (VersionedLock::is_locked(before)) {
+                    if (before == owner) { // Memory only changes at write-back, and the version was no greater than 'rv'
+                        ::std::memcpy(dest, chunk, len);
+                        return true;
+                    }
+                    if (!Contention::on_busy(tx.cm, attempt))
+                        return false;
+                    continue;
+                }
+                if (unlikely(VersionedLock::version(before) > tx.rv))
+                    return false;
+                ::std::memcpy(dest, chunk, len);
+                ::std::atomic_thread_fence(::std::memory_order_acquire);
+                if (unlikely(lock.load() != before)) // Concurrent write-back, try again
+                    continue;
+                if (!tx.is_ro) {
+                    try {
+                        tx.reads.add(lock);
+                    } catch (::std::bad_alloc const&) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        });
+        if (unlikely(!valid)) {
+            abort(tx);
+            return false;
+        }
+        if (!tx.is_ro)
+            tx.writes.overlay(source, size, target);
+        return true;
+    }
+    /** [thread-safe] Write operation in the given transaction, source in a private region and target in the shared region.
+     * @param shared Shared memory region associated with the transaction
+     * @param txid   Transaction to use
+     * @param source Source start address (in a private region)
+     * @param size   Length to copy (in bytes), must be a positive multiple of the alignment
+     * @param target Target start address (in the shared region)
+     * @return Whether the whole transaction can continue
+    **/
+    static bool write(shared_t shared [[gnu::unused]], tx_t txid, void const* source, size_t size, void* target) noexcept {
+        auto& tx = *reinterpret_cast<Transaction*>(txid);
+        if (WriteLog::encounter_time) {
+            auto locked = tx.region->locks.for_each(target, size, [&](VersionedLock& lock, void*, size_t) {
+                return acquire(tx, lock);
+            });
+            if (unlikely(!locked)) {
+                abort(tx);
+                return false;
+            }
+        }
+        try {
+            tx.writes.add(source, size, target);
+        } catch (::std::bad_alloc const&) {
+            abort(tx);
+            return false;
+        }
+        return true;
+    }
+    /** [thread-safe] Memory allocation in the given transaction.
+     * @param shared Shared memory region associated with the transaction
+     * @param txid   Transaction to use
+     * @param size   Allocation requested size (in bytes), must be a positive multiple of the alignment
+     * @param target Pointer in private memory receiving the address of the first byte of the newly allocated, aligned segment
+     * @return Whether the whole transaction can continue (success/nomem), or not (abort)
+    **/
+    static Alloc alloc(shared_t shared [[gnu::unused]], tx_t txid, size_t size, void** target) noexcept {
+        auto& tx = *reinterpret_cast<Transaction*>(txid);
+        auto& region = *tx.region;
+        auto segment = reinterpret_cast<Segment*>(Allocator::allocate(region.delta_alloc + size, region.align_alloc));
+        if (unlikely(!segment))
+            return Alloc::nomem;
+        try { // Recorded first, so that an abort finds every chained segment of the transaction
+            tx.allocated.push_back(segment);
+        } catch (::std::bad_alloc const&) {
+            Allocator::release(segment, region.delta_alloc + size);
+            return Alloc::nomem;
+        }
+        segment->size = size;
+        { // Chain the segment, for 'tm_destroy'
+            ::std::unique_lock<decltype(region.segments_lock)> guard{region.segments_lock};
+            auto sentinel = &(region.segments);
+            segment->prev = sentinel->prev;
+            segment->next = sentinel;
+            sentinel->prev->next = segment;
+            sentinel->prev = segment;
+        }
+        *target = data_of(region, segment);
+        return Alloc::success;
+    }
+    /** [thread-safe] Memory freeing in the given transaction.
+     * @param shared Shared memory region associated with the transaction
+     * @param txid   Transaction to use
+     * @param target Address of the first byte of the previously allocated segment to deallocate
+     * @return Whether the whole transaction can continue
+    **/
+    static bool free(shared_t shared [[gnu::unused]], tx_t txid, void* target) noexcept {
+        auto& tx = *reinterpret_cast<Transaction*>(txid);
+        try {
+            tx.freed.push_back(segment_of(*tx.region, target));
+        } catch (::std::bad_alloc const&) {
+            abort(tx);
+            return false;
+        }
+        return true;
+    }
+};
+
+}
+
+// -------------------------------------------------------------------------- //
+
+/** Define the 'tm_*' functions of 'tm.hpp' for the given variant.
+ * @param variant 'Engine::Manager' instantiation
+**/
+#define ENGINE_EXPORT(variant) \
+    shared_t tm_create(size_t size, size_t align) noexcept { return variant::create(size, align); } \
+    void tm_destroy(shared_t shared) noexcept { variant::destroy(shared); } \
+    void* tm_start(shared_t shared) noexcept { return variant::start(shared); } \
+    size_t tm_size(shared_t shared) noexcept { return variant::size(shared); } \
+    size_t tm_align(shared_t shared) noexcept { return variant::align(shared); } \
+    tx_t tm_begin(shared_t shared, bool is_ro) noexcept { return variant::begin(shared, is_ro); } \
+    bool tm_end(shared_t shared, tx_t tx) noexcept { return variant::end(shared, tx); } \
+    bool tm_read(shared_t shared, tx_t tx, void const* source, size_t size, void* target) noexcept { return variant::read(shared, tx, source, size, target); } \
+    bool tm_write(shared_t shared, tx_t tx, void const* source, size_t size, void* target) noexcept { return variant::write(shared, tx, source, size, target); } \
+    Alloc tm_alloc(shared_t shared, tx_t tx, size_t size, void** target) noexcept { return variant::alloc(shared, tx, size, target); } \
+    bool tm_free(shared_t shared, tx_t tx, void* target) noexcept { return variant::free(shared, tx, target); }
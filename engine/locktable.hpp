@@ -0,0 +1,123 @@
+/**
+ * @file   locktable.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Lock table policies, mapping shared memory addresses to versioned locks.
+**/
+
+#pragma once
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+namespace LockTable {
+
+/** Lock table base class, iterating over the stripes of a given range.
+ * @param Derived   Derived class, providing 'index(Word stripe)'
+ * @param LogSize   Base-2 logarithm of the number of locks
+ * @param LogStripe Base-2 logarithm of the stripe size (in bytes)
+**/
+template<class Derived, unsigned int LogSize, unsigned int LogStripe> class Base: private NonCopyable {
+public:
+    constexpr static size_t nb_locks    = size_t{1} << LogSize;   // Number of locks
+    constexpr static size_t stripe_size = size_t{1} << LogStripe; // Stripe size (in bytes)
+private:
+    VersionedLock* locks; // Array of locks
+public:
+    /** Null constructor.
+    **/
+    Base() noexcept: locks{nullptr} {}
+public:
+    /** Allocate the (zero-initialized, i.e. version 0 and unlocked) lock array.
+     * @param Allocator Allocator policy to use
+     * @return Whether the operation is a success
+    **/
+    template<class Allocator> bool init() noexcept {
+        // Zeroed memory is a valid representation for an array of (unlocked, version 0) 'VersionedLock'
+        locks = reinterpret_cast<VersionedLock*>(Allocator::allocate(nb_locks * sizeof(VersionedLock), cache_line));
+        return locks != nullptr;
+    }
+    /** Free the lock array.
+     * @param Allocator Allocator policy used at initialization
+    **/
+    template<class Allocator> void fini() noexcept {
+        Allocator::release(locks, nb_locks * sizeof(VersionedLock));
+    }
+public:
+    /** Get the lock protecting the stripe at the given address.
+     * @param addr Address in shared memory
+     * @return Associated lock
+    **/
+    VersionedLock& get(void const* addr) noexcept {
+        return locks[Derived::index(reinterpret_cast<Word>(addr) >> LogStripe)];
+    }
+    /** Call the given function on each stripe intersecting the given range, stopping at the first failure.
+     * @param addr Range start address
+     * @param size Range size (in bytes)
+     * @param func Function to call (VersionedLock&, void* chunk start, size_t chunk size -> bool)
+     * @return Whether every call succeeded
+    **/
+    template<class Func> bool for_each(void const* addr, size_t size, Func&& func) noexcept {
+        auto start = reinterpret_cast<Word>(addr);
+        auto end   = start + size;
+        for (auto stripe = start >> LogStripe; start < end; ++stripe) {
+            auto next = (stripe + 1) << LogStripe;
+            auto stop = next < end ? next : end;
+            if (unlikely(!func(locks[Derived::index(stripe)], reinterpret_cast<void*>(start), static_cast<size_t>(stop - start))))
+                return false;
+            start = stop;
+        }
+        return true;
+    }
+};
+
+/** Direct-mapped lock table, consecutive stripes map to consecutive locks.
+ * @param LogSize   Base-2 logarithm of the number of locks
+ * @param LogStripe Base-2 logarithm of the stripe size (in bytes)
+**/
+template<unsigned int LogSize = 20, unsigned int LogStripe = 3> class Striped final: public Base<Striped<LogSize, LogStripe>, LogSize, LogStripe> {
+public:
+    /** Map a stripe number to a lock index.
+     * @param stripe Stripe number
+     * @return Lock index
+    **/
+    constexpr static size_t index(Word stripe) noexcept {
+        return static_cast<size_t>(stripe & ((Word{1} << LogSize) - 1));
+    }
+};
+
+/** Hashed lock table, stripes are spread over the locks with a multiplicative (Fibonacci) hash.
+ * @param LogSize   Base-2 logarithm of the number of locks
+ * @param LogStripe Base-2 logarithm of the stripe size (in bytes)
+**/
+template<unsigned int LogSize = 20, unsigned int LogStripe = 3> class Hashed final: public Base<Hashed<LogSize, LogStripe>, LogSize, LogStripe> {
+public:
+    /** Map a stripe number to a lock index.
+     * @param stripe Stripe number
+     * @return Lock index
+    **/
+    constexpr static size_t index(Word stripe) noexcept {
+        return static_cast<size_t>((static_cast<uint64_t>(stripe) * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - LogSize));
+    }
+};
+
+}
+}
@@ -0,0 +1,124 @@
+/**
+ * @file   readlog.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Read log policies, recording the locks to validate at commit time.
+**/
+
+#pragma once
+
+// External headers
+#include <vector>
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+namespace ReadLog {
+
+/** Plain vector of read locks.
+**/
+class Vector final: private NonCopyable {
+private:
+    ::std::vector<VersionedLock const*> entries; // Read locks, in read order
+public:
+    /** Default constructor.
+    **/
+    Vector() = default;
+public:
+    /** Forget every entry, keeping the allocated storage.
+    **/
+    void clear() noexcept {
+        entries.clear();
+    }
+    /** Reserve storage for the given number of entries.
+     * @param count Number of entries
+    **/
+    void reserve(size_t count) {
+        entries.reserve(count);
+    }
+    /** Record a read lock, throws '::std::bad_alloc' when out of memory.
+     * @param lock Lock protecting the read stripe
+    **/
+    void add(VersionedLock const& lock) {
+        entries.push_back(&lock);
+    }
+    /** Call the given predicate on every recorded lock, stopping at the first failure.
+     * @param pred Predicate to call (VersionedLock const& -> bool)
+     * @return Whether every call succeeded
+    **/
+    template<class Pred> bool all(Pred&& pred) const noexcept {
+        for (auto lock: entries) {
+            if (unlikely(!pred(*lock)))
+                return false;
+        }
+        return true;
+    }
+};
+
+/** Vector of read locks, skipping an entry identical to the last recorded one.
+ *
+ * Cheap deduplication for multi-word values and repeated reads of the same stripe.
+**/
+class Filtered final: private NonCopyable {
+private:
+    ::std::vector<VersionedLock const*> entries; // Read locks, in read order
+    VersionedLock const* last; // Last recorded lock
+public:
+    /** Default constructor.
+    **/
+    Filtered(): last{nullptr} {}
+public:
+    /** Forget every entry, keeping the allocated storage.
+    **/
+    void clear() noexcept {
+        entries.clear();
+        last = nullptr;
+    }
+    /** Reserve storage for the given number of entries.
+     * @param count Number of entries
+    **/
+    void reserve(size_t count) {
+        entries.reserve(count);
+    }
+    /** Record a read lock, throws '::std::bad_alloc' when out of memory.
+     * @param lock Lock protecting the read stripe
+    **/
+    void add(VersionedLock const& lock) {
+        if (&lock == last)
+            return;
+        entries.push_back(&lock);
+        last = &lock;
+    }
+    /** Call the given predicate on every recorded lock, stopping at the first failure.
+     * @param pred Predicate to call (VersionedLock const& -> bool)
+     * @return Whether every call succeeded
+    **/
+    template<class Pred> bool all(Pred&& pred) const noexcept {
+        for (auto lock: entries) {
+            if (unlikely(!pred(*lock)))
+                return false;
+        }
+        return true;
+    }
+};
+
+}
+}
@@ -0,0 +1,37 @@
+/**
+ * @file   gv1-striped-etl-spin.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Fetch-and-increment clock, direct-mapped 16-byte stripes, encounter-time locking, bounded spinning.
+**/
+
+// Internal headers
+#include "engine.hpp"
+
+// -------------------------------------------------------------------------- //
+
+using Variant = Engine::Manager<
+    Engine::Clock::GV1,
+    Engine::LockTable::Striped<18, 4>,
+    Engine::ReadLog::Filtered,
+    Engine::WriteLog::ETL,
+    Engine::Contention::Spin<64>,
+    Engine::Allocator::Mmap>;
+
+ENGINE_EXPORT(Variant)
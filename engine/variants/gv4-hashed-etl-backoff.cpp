@@ -0,0 +1,37 @@
+/**
+ * @file   gv4-hashed-etl-backoff.cpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * GV4 clock, hashed stripes, encounter-time locking, exponential backoff.
+**/
+
+// Internal headers
+#include "engine.hpp"
+
+// -------------------------------------------------------------------------- //
+
+using Variant = Engine::Manager<
+    Engine::Clock::GV4,
+    Engine::LockTable::Hashed<20, 3>,
+    Engine::ReadLog::Filtered,
+    Engine::WriteLog::ETL,
+    Engine::Contention::Backoff<4, 16, 16>,
+    Engine::Allocator::Heap>;
+
+ENGINE_EXPORT(Variant)
@@ -0,0 +1,158 @@
+/**
+ * @file   writelog.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Write log policies, buffering the speculative writes (redo log) and selecting when the written stripes get locked.
+**/
+
+#pragma once
+
+// External headers
+#include <cstring>
+#include <vector>
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+namespace Engine {
+namespace WriteLog {
+
+/** Redo log, buffering the written values until commit.
+**/
+class Redo: private NonCopyable {
+private:
+    /** Buffered write.
+    **/
+    struct Entry {
+        void*  target; // Target address in shared memory
+        size_t size;   // Size of the write (in bytes)
+        size_t offset; // Offset of the written value in the value buffer
+    };
+private:
+    ::std::vector<Entry> entries; // Buffered writes, in program order
+    ::std::vector<char>  values;  // Written values
+    uint64_t filter; // Bloom filter over the written words
+private:
+    /** Compute the Bloom filter mask of the given range.
+     * @param addr Range start address
+     * @param size Range size (in bytes)
+     * @return Associated mask
+    **/
+    static uint64_t mask(void const* addr, size_t size) noexcept {
+        auto start = reinterpret_cast<Word>(addr) / sizeof(Word);
+        auto end   = (reinterpret_cast<Word>(addr) + size + sizeof(Word) - 1) / sizeof(Word);
+        if (end - start >= 64)
+            return ~uint64_t{0};
+        uint64_t res = 0;
+        for (auto word = start; word < end; ++word)
+            res |= uint64_t{1} << (word % 64);
+        return res;
+    }
+public:
+    /** Default constructor.
+    **/
+    Redo(): filter{0} {}
+public:
+    /** Forget every entry, keeping the allocated storage.
+    **/
+    void clear() noexcept {
+        entries.clear();
+        values.clear();
+        filter = 0;
+    }
+    /** Reserve storage for the given number of entries.
+     * @param count Number of entries
+    **/
+    void reserve(size_t count) {
+        entries.reserve(count);
+        values.reserve(count * sizeof(Word));
+    }
+    /** Check whether the log is empty.
+     * @return Whether the log is empty
+    **/
+    bool empty() const noexcept {
+        return entries.empty();
+    }
+    /** Buffer a write, throws '::std::bad_alloc' when out of memory (the log then only fits a 'clear').
+     * @param source Source address in private memory
+     * @param size   Size of the write (in bytes)
+     * @param target Target address in shared memory
+    **/
+    void add(void const* source, size_t size, void* target) {
+        auto offset = values.size();
+        values.resize(offset + size);
+        ::std::memcpy(values.data() + offset, source, size);
+        entries.push_back(Entry{target, size, offset});
+        filter |= mask(target, size);
+    }
+    /** Overwrite the given private copy of a shared range with the buffered writes it intersects.
+     * @param source Source address in shared memory
+     * @param size   Size of the range (in bytes)
+     * @param target Private copy of the range
+    **/
+    void overlay(void const* source, size_t size, void* target) const noexcept {
+        if (likely((filter & mask(source, size)) == 0))
+            return;
+        auto start = reinterpret_cast<Word>(source);
+        auto end   = start + size;
+        for (auto&& entry: entries) { // In program order, so that the last write wins
+            auto estart = reinterpret_cast<Word>(entry.target);
+            auto eend   = estart + entry.size;
+            auto lo = estart > start ? estart : start;
+            auto hi = eend < end ? eend : end;
+            if (lo < hi)
+                ::std::memcpy(reinterpret_cast<char*>(target) + (lo - start), values.data() + entry.offset + (lo - estart), hi - lo);
+        }
+    }
+    /** Call the given function on every buffered write, stopping at the first failure.
+     * @param func Function to call (void* target, size_t size -> bool)
+     * @return Whether every call succeeded
+    **/
+    template<class Func> bool all(Func&& func) const noexcept {
+        for (auto&& entry: entries) {
+            if (unlikely(!func(entry.target, entry.size)))
+                return false;
+        }
+        return true;
+    }
+    /** Write back every buffered write to shared memory, in program order.
+    **/
+    void write_back() const noexcept {
+        for (auto&& entry: entries)
+            ::std::memcpy(entry.target, values.data() + entry.offset, entry.size);
+    }
+};
+
+/** Commit-time locking: written stripes are locked in 'tm_end' only.
+**/
+class CTL final: public Redo {
+public:
+    constexpr static bool encounter_time = false;
+};
+
+/** Encounter-time locking: written stripes are locked in 'tm_write', so that write-write conflicts are detected early.
+**/
+class ETL final: public Redo {
+public:
+    constexpr static bool encounter_time = true;
+};
+
+}
+}
@@ -0,0 +1,176 @@
+/**
+ * @file   affinity.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Placement of the worker threads on the processors.
+**/
+
+#pragma once
+
+// External headers
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+extern "C" {
+#include <pthread.h>
+#include <sched.h>
+}
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Processor topology, as described in '/sys/devices/system/cpu' and restricted to the processors the process may run on.
+**/
+class Topology final {
+public:
+    /** Processor (hardware thread) description.
+    **/
+    struct Cpu {
+        int id;      // Processor ID
+        int package; // Socket ID
+        int core;    // Core ID (in its socket)
+        int smt;     // Rank among the hardware threads of its core
+    };
+private:
+    ::std::vector<Cpu> cpus; // Usable processors, by ID
+private:
+    /** Read a list file (e.g. "0-3,8").
+     * @param path File path
+     * @return Listed IDs (empty if the file cannot be read)
+    **/
+    static ::std::vector<int> read_list(::std::string const& path) {
+        ::std::ifstream file{path};
+        ::std::string text;
+        ::std::vector<int> res;
+        if (!::std::getline(file, text))
+            return res;
+        ::std::istringstream items{text};
+        ::std::string item;
+        while (::std::getline(items, item, ',')) {
+            if (item.empty() || item == "\n")
+                continue;
+            auto dash = item.find('-');
+            auto first = ::std::stoi(item.substr(0, dash));
+            auto last  = dash == ::std::string::npos ? first : ::std::stoi(item.substr(dash + 1));
+            for (auto id = first; id <= last; ++id)
+                res.push_back(id);
+        }
+        return res;
+    }
+    /** Read an integer file.
+     * @param path File path
+     * @param def  Value if the file cannot be read
+     * @return Read value
+    **/
+    static int read_int(::std::string const& path, int def) {
+        ::std::ifstream file{path};
+        int res;
+        if (!(file >> res))
+            return def;
+        return res;
+    }
+public:
+    /** Read constructor.
+     * @param root Processor description directory (optional)
+    **/
+    Topology(::std::string const& root = "/sys/devices/system/cpu") {
+        ::cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        auto restricted = ::sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+        for (auto id: read_list(root + "/online")) {
+            if (id >= CPU_SETSIZE || (restricted && !CPU_ISSET(id, &allowed)))
+                continue;
+            auto dir = root + "/cpu" + ::std::to_string(id) + "/topology/";
+            auto siblings = read_list(dir + "thread_siblings_list");
+            auto rank = ::std::find(siblings.begin(), siblings.end(), id) - siblings.begin();
+            cpus.push_back(Cpu{id, read_int(dir + "physical_package_id", 0), read_int(dir + "core_id", id), rank < static_cast<decltype(rank)>(siblings.size()) ? static_cast<int>(rank) : 0});
+        }
+    }
+public:
+    /** Get the usable processors.
+     * @return Processors, by ID
+    **/
+    auto const& get_cpus() const noexcept {
+        return cpus;
+    }
+    /** Order processors compactly: the cores of the first socket, then their other hardware threads, then the next socket.
+     * @param cpus Processors
+     * @return Processor IDs, in order
+    **/
+    static ::std::vector<int> compact(::std::vector<Cpu> cpus) {
+        ::std::stable_sort(cpus.begin(), cpus.end(), [](Cpu const& a, Cpu const& b) {
+            if (a.package != b.package)
+                return a.package < b.package;
+            if (a.smt != b.smt)
+                return a.smt < b.smt;
+            return a.core < b.core;
+        });
+        ::std::vector<int> res;
+        for (auto const& cpu: cpus)
+            res.push_back(cpu.id);
+        return res;
+    }
+    /** Order processors by scattering them: round-robin across the sockets, each one filled compactly.
+     * @param cpus Processors
+     * @return Processor IDs, in order
+    **/
+    static ::std::vector<int> scatter(::std::vector<Cpu> const& cpus) {
+        ::std::vector<int> packages; // Socket IDs, in order
+        for (auto const& cpu: cpus) {
+            if (::std::find(packages.begin(), packages.end(), cpu.package) == packages.end())
+                packages.push_back(cpu.package);
+        }
+        ::std::sort(packages.begin(), packages.end());
+        ::std::vector<::std::vector<int>> orders; // Compact order of each socket
+        for (auto package: packages) {
+            ::std::vector<Cpu> own;
+            for (auto const& cpu: cpus) {
+                if (cpu.package == package)
+                    own.push_back(cpu);
+            }
+            orders.push_back(compact(own));
+        }
+        ::std::vector<int> res;
+        for (size_t rank = 0; res.size() < cpus.size(); ++rank) {
+            for (auto const& order: orders) {
+                if (rank < order.size())
+                    res.push_back(order[rank]);
+            }
+        }
+        return res;
+    }
+};
+
+/** Pin the calling thread to a processor.
+ * @param cpu Processor ID
+ * @return Whether the thread is pinned
+**/
+static bool pin_thread(int cpu) noexcept {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
@@ -41,6 +41,9 @@ extern "C" {
 #if (defined(__i386__) || defined(__x86_64__)) && defined(USE_MM_PAUSE)
 #   include <xmmintrin.h>
 #endif
+#if defined(__i386__) || defined(__x86_64__)
+#   include <x86intrin.h>
+#endif
 }
 
 // -------------------------------------------------------------------------- //
@@ -205,11 +208,54 @@ public:
     }
 };
 
+/** Cheap time stamps, for measurements around each transaction: the TSC where available, the monotonic clock (in ns) otherwise.
+**/
+class Stamp final {
+public:
+    /** Tick class.
+    **/
+    using Tick = uint_fast64_t;
+public:
+    /** Take a time stamp.
+     * @return Current tick
+    **/
+    static Tick now() noexcept {
+#if defined(__i386__) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        struct ::timespec buf;
+        ::clock_gettime(CLOCK_MONOTONIC, &buf);
+        return static_cast<Tick>(buf.tv_nsec) + static_cast<Tick>(buf.tv_sec) * static_cast<Tick>(1000000000ul);
+#endif
+    }
+    /** [thread-safe] Get the number of ticks per ns, calibrated against the monotonic clock on first call (which takes about 20 ms).
+     * @return Ticks per ns
+    **/
+    static double per_ns() {
+        static double const res = []() {
+#if defined(__i386__) || defined(__x86_64__)
+            Chrono chrono;
+            chrono.start();
+            auto first = now();
+            ::std::this_thread::sleep_for(::std::chrono::milliseconds(20));
+            auto last = now();
+            chrono.stop();
+            if (unlikely(chrono.get_tick() == 0))
+                return 1.;
+            return static_cast<double>(last - first) / static_cast<double>(chrono.get_tick());
+#else
+            return 1.;
+#endif
+        }();
+        return res;
+    }
+};
+
 // -------------------------------------------------------------------------- //
 
 /** Pause execution for a "short" period of time.
 **/
-static void short_pause() {
+static inline void short_pause() {
 #if (defined(__i386__) || defined(__x86_64__)) && defined(USE_MM_PAUSE)
     _mm_pause();
 #else
@@ -219,7 +265,7 @@ static void short_pause() {
 
 /** Pause execution for a "longer" period of time.
 **/
-static void long_pause() {
+static inline void long_pause() {
     ::std::this_thread::sleep_for(::std::chrono::milliseconds(200));
 }
 
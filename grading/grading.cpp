@@ -24,14 +24,39 @@
 // External headers
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 // Internal headers
+#include "affinity.hpp"
 #include "common.hpp"
+#include "perf.hpp"
 #include "transactional.hpp"
 #include "workload.hpp"
+extern "C" {
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+}
+
+// -------------------------------------------------------------------------- //
+namespace Exception {
+
+EXCEPTION(Isolation, Any, "unable to run an evaluation in a child process");
+
+}
 
 // -------------------------------------------------------------------------- //
 
@@ -134,6 +159,70 @@ public:
     }
 };
 
+/** Sampler of the cumulative commits of the workers, every given period from its own thread.
+**/
+class Monitor final {
+private:
+    TransactionCounts const* const* counts; // Counts of each worker
+    unsigned int const nbworkers;           // Number of workers
+    Chrono::Tick const period;              // Sampling period (in ns)
+    ::std::atomic<bool> stopped;            // Whether the sampling must stop
+    ::std::vector<uint_fast64_t> samples;   // Cumulative commits at each sample, the first one at start
+    ::std::thread thread;                   // Sampling thread
+private:
+    /** Sum the commits of the workers.
+     * @return Total number of commits
+    **/
+    uint_fast64_t sum() const noexcept {
+        uint_fast64_t total = 0;
+        for (unsigned int i = 0; i < nbworkers; ++i)
+            total += counts[i]->get_commits();
+        return total;
+    }
+public:
+    /** Deleted copy constructor/assignment.
+    **/
+    Monitor(Monitor const&) = delete;
+    Monitor& operator=(Monitor const&) = delete;
+    /** Start sampling constructor.
+     * @param counts    Counts of each worker (to outlive the instance)
+     * @param nbworkers Number of workers
+     * @param period    Sampling period (in ns)
+    **/
+    Monitor(TransactionCounts const* const* counts, unsigned int nbworkers, Chrono::Tick period): counts{counts}, nbworkers{nbworkers}, period{period}, stopped{false} {
+        samples.push_back(sum());
+        thread = ::std::thread{[this]() {
+            auto next = ::std::chrono::steady_clock::now();
+            while (!stopped.load(::std::memory_order_relaxed)) {
+                next += ::std::chrono::nanoseconds{this->period};
+                ::std::this_thread::sleep_until(next);
+                samples.push_back(sum());
+            }
+        }};
+    }
+    /** Stop sampling destructor.
+    **/
+    ~Monitor() {
+        stop();
+    }
+public:
+    /** Stop sampling, then get the number of commits in each period.
+     * @return Commits per period, up to the last one with commits (the master notices the end of a run up to a long pause late)
+    **/
+    ::std::vector<uint_fast64_t> stop() {
+        if (thread.joinable()) {
+            stopped.store(true, ::std::memory_order_relaxed);
+            thread.join();
+        }
+        ::std::vector<uint_fast64_t> res;
+        for (size_t i = 1; i < samples.size(); ++i)
+            res.push_back(samples[i] - samples[i - 1]);
+        while (!res.empty() && res.back() == 0)
+            res.pop_back();
+        return res;
+    }
+};
+
 /** Measure the arithmetic mean of the execution time of the given workload with the given transaction library.
  * @param workload     Workload instance to use
  * @param nbthreads    Number of concurrent threads to use
@@ -142,21 +231,35 @@ public:
  * @param maxtick_init Timeout for (re)initialization ('Chrono::invalid_tick' for none)
  * @param maxtick_perf Timeout for performance measurements ('Chrono::invalid_tick' for none)
  * @param maxtick_chck Timeout for correctness check ('Chrono::invalid_tick' for none)
+ * @param aborts       Aborted attempts of the workers, by transaction type and reason (added to)
+ * @param counts       Attempts of the workers, by transaction type (added to)
+ * @param latencies    Latencies of the workers (in 'Stamp' ticks), by transaction type (array of 'AbortCounts::nbtypes', added to)
+ * @param open         Open-loop statistics of the workers (added to)
+ * @param period       Sampling period of the commits (in ns)
+ * @param series       Commits of the workers in each sampling period of the median repetition (replaced)
+ * @param repetitions  Execution time (in ns) of each repetition, in order (replaced)
+ * @param counters     Hardware counters of the workers over all the repetitions (replaced, set once the workers are initialized)
+ * @param cpus         Processor of each worker, cyclically (empty for no pinning)
  * @return Error constant null-terminated string ('nullptr' for none), execution times (in ns) (undefined if inconsistency detected)
 **/
-static auto measure(Workload& workload, unsigned int const nbthreads, unsigned int const nbrepeats, Seed seed, Chrono::Tick maxtick_init, Chrono::Tick maxtick_perf, Chrono::Tick maxtick_chck) {
-    // TODO: Should fork
+static auto measure(Workload& workload, unsigned int const nbthreads, unsigned int const nbrepeats, Seed seed, Chrono::Tick maxtick_init, Chrono::Tick maxtick_perf, Chrono::Tick maxtick_chck, AbortCounts& aborts, TransactionCounts& counts, LatencyHistogram* latencies, OpenLoopStats& open, Chrono::Tick period, ::std::vector<uint_fast64_t>& series, ::std::vector<Chrono::Tick>& repetitions, ::std::unique_ptr<PerfCounters>& counters, ::std::vector<int> const& cpus) {
     ::std::thread threads[nbthreads];
+    TransactionCounts const* workers[nbthreads]; // Counts of each worker, sampled during the performance measurements
+    pid_t tids[nbthreads];                       // Thread ID of each worker, for the hardware counters
     ::std::mutex  cerrlock;        // To avoid interleaving writes to 'cerr' in case more than one thread throw
     Sync          sync{nbthreads}; // "As-synchronized-as-possible" starts so that threads interfere "as-much-as-possible"
     for (unsigned int i = 0; i < nbthreads; ++i) { // Start threads
         try {
             threads[i] = ::std::thread{[&](unsigned int i) {
                 try {
+                    auto pinned = cpus.empty() || pin_thread(cpus[i % cpus.size()]); // Same placement for every repetition
+                    workers[i] = &transactional_counts;
+                    tids[i] = static_cast<pid_t>(::syscall(SYS_gettid));
                     // Initialization
                     if (!sync.worker_wait())
                         return;
-                    sync.worker_notify(workload.init());
+                    auto error = workload.init();
+                    sync.worker_notify(pinned ? error : "Unable to pin a worker thread to its processor");
                     // Performance measurements
                     for (unsigned int count = 0; count < nbrepeats; ++count) {
                         if (!sync.worker_wait())
@@ -167,6 +270,14 @@ static auto measure(Workload& workload, unsigned int const nbthreads, unsigned i
                     if (!sync.worker_wait())
                         return;
                     sync.worker_notify(workload.check(i, std::random_device{}())); // Random seed is wanted here
+                    { // Report the aborts of this worker
+                        ::std::unique_lock<decltype(cerrlock)> guard{cerrlock};
+                        aborts += transactional_abort_counts;
+                        counts += transactional_counts;
+                        for (size_t type = 0; type < AbortCounts::nbtypes; ++type)
+                            latencies[type] += transactional_latencies[type];
+                        open += workload_open_loop;
+                    }
                     // Synchronized quit
                     if (!sync.worker_wait())
                         return;
@@ -190,6 +301,7 @@ static auto measure(Workload& workload, unsigned int const nbthreads, unsigned i
         char const* error = nullptr;
         Chrono::Tick time_init = Chrono::invalid_tick;
         Chrono::Tick times[nbrepeats];
+        ::std::vector<::std::vector<uint_fast64_t>> samples(nbrepeats);
         Chrono::Tick time_chck = Chrono::invalid_tick;
         auto const posmedian = nbrepeats / 2;
         { // Initialization (with cheap correctness test)
@@ -203,16 +315,27 @@ static auto measure(Workload& workload, unsigned int const nbthreads, unsigned i
             time_init = chrono.get_tick();
         }
         { // Performance measurements (with cheap correctness tests)
+            counters.reset(new PerfCounters{tids, nbthreads}); // Workers known since their initialization
             for (unsigned int i = 0; i < nbrepeats; ++i) {
+                Monitor monitor{workers, nbthreads, period};
                 Chrono chrono;
                 chrono.start();
+                counters->start();
                 sync.master_notify();
                 error = sync.master_wait(maxtick_perf);
+                counters->stop();
                 if (unlikely(error))
                     goto join;
                 chrono.stop();
                 times[i] = chrono.get_tick();
+                samples[i] = monitor.stop();
             }
+            unsigned int order[nbrepeats];
+            for (unsigned int i = 0; i < nbrepeats; ++i)
+                order[i] = i;
+            ::std::nth_element(order, order + posmedian, order + nbrepeats, [&](unsigned int a, unsigned int b) { return times[a] < times[b]; }); // Partition repetitions around the median
+            series = ::std::move(samples[order[posmedian]]);
+            repetitions.assign(times, times + nbrepeats);
             ::std::nth_element(times, times + posmedian, times + nbrepeats); // Partition times around the median
         }
         { // Correctness check
@@ -238,6 +361,247 @@ static auto measure(Workload& workload, unsigned int const nbthreads, unsigned i
     }
 }
 
+/** Parse a list of worker counts.
+ * @param list Comma-separated counts or inclusive ranges of counts (e.g. "1-4,8,16")
+ * @param min  Smallest valid count (optional)
+ * @return Worker counts, in the given order
+**/
+static auto parse_counts(char const* list, size_t min = 1) {
+    ::std::vector<size_t> res;
+    ::std::string text{list};
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        auto end = text.find(',', pos);
+        if (end == ::std::string::npos)
+            end = text.size();
+        auto item = text.substr(pos, end - pos);
+        auto dash = item.find('-');
+        size_t first = ::std::stoul(item.substr(0, dash));
+        size_t last  = dash == ::std::string::npos ? first : ::std::stoul(item.substr(dash + 1));
+        if (first < min || last < first)
+            throw ::std::invalid_argument{"invalid range '" + item + "'"};
+        for (auto count = first; count <= last; ++count)
+            res.push_back(count);
+        pos = end + 1;
+    }
+    return res;
+}
+
+/** Parse a list of rates.
+ * @param list Comma-separated positive rates (e.g. "50000,100000,2e5")
+ * @return Rates, in the given order
+**/
+static auto parse_rates(char const* list) {
+    ::std::vector<double> res;
+    ::std::string text{list};
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        auto end = text.find(',', pos);
+        if (end == ::std::string::npos)
+            end = text.size();
+        auto item = text.substr(pos, end - pos);
+        auto rate = ::std::stod(item);
+        if (!(rate > 0.))
+            throw ::std::invalid_argument{"invalid rate '" + item + "'"};
+        res.push_back(rate);
+        pos = end + 1;
+    }
+    return res;
+}
+
+/** Open-loop results of an evaluation at one offered rate.
+**/
+struct OpenLoopPoint {
+    double offered;  // Offered rate (in TX/s)
+    double achieved; // Achieved rate (in TX/s)
+    double p99;      // 99th percentile of the response times (in ns)
+};
+
+/** Workload parameters, settable by command line options or a configuration file.
+**/
+class Parameters final {
+public:
+    size_t nbtxperwrk    = 0;    // Number of transactions per worker (0 for 400000 in total)
+    size_t nbaccounts    = 0;    // Initial number of accounts (0 for 32 per worker)
+    size_t expnbaccounts = 0;    // Expected number of accounts (0 for 1024 per worker)
+    size_t init_balance  = 100;  // Initial balance of the accounts
+    float  prob_long     = -1.f; // Probability of long transactions (negative for the default of the mode)
+    float  prob_alloc    = -1.f; // Probability of allocation transactions (negative for the default of the mode)
+    size_t nbrepeats     = 7;    // Number of repetitions (keep the median)
+    size_t slow_factor   = 100;  // Timeout, as a multiple of the time of the reference
+public:
+    /** Set a parameter.
+     * @param name  Parameter name, as its option without the leading dashes
+     * @param value Parameter value
+     * @return Whether the parameter exists
+    **/
+    bool set(::std::string const& name, ::std::string const& value) {
+        if (name == "txs-per-worker") {
+            nbtxperwrk = ::std::stoul(value);
+        } else if (name == "accounts") {
+            nbaccounts = ::std::stoul(value);
+        } else if (name == "expected-accounts") {
+            expnbaccounts = ::std::stoul(value);
+        } else if (name == "balance") {
+            init_balance = ::std::stoul(value);
+        } else if (name == "prob-long") {
+            prob_long = ::std::stof(value);
+        } else if (name == "prob-alloc") {
+            prob_alloc = ::std::stof(value);
+        } else if (name == "repeats") {
+            nbrepeats = ::std::stoul(value);
+            if (nbrepeats == 0)
+                throw ::std::invalid_argument{"at least one repetition is needed"};
+        } else if (name == "slow-factor") {
+            slow_factor = ::std::stoul(value);
+        } else {
+            return false;
+        }
+        return true;
+    }
+    /** Set the parameters of a configuration file, made of "<name> = <value>" lines ('#' starting a comment).
+     * @param path Configuration file path
+    **/
+    void load(char const* path) {
+        ::std::ifstream file{path};
+        if (!file)
+            throw ::std::invalid_argument{"unable to read configuration file '" + ::std::string{path} + "'"};
+        ::std::string line;
+        for (size_t number = 1; ::std::getline(file, line); ++number) {
+            line = line.substr(0, line.find('#'));
+            auto equal = line.find('=');
+            auto trim = [](::std::string const& text) {
+                auto first = text.find_first_not_of(" \t\r");
+                return first == ::std::string::npos ? ::std::string{} : text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+            };
+            if (trim(line).empty())
+                continue;
+            if (equal == ::std::string::npos || !set(trim(line.substr(0, equal)), trim(line.substr(equal + 1))))
+                throw ::std::invalid_argument{"invalid line " + ::std::to_string(number) + " in configuration file '" + path + "'"};
+        }
+    }
+};
+
+/** Results of an evaluation, sent back by its child process (followed by its JSON object without the closing brace, if any).
+**/
+struct Report {
+    Chrono::Tick tick_init; // Initialization time (in ns)
+    Chrono::Tick tick_perf; // Median performance measurement time (in ns)
+    Chrono::Tick tick_chck; // Correctness check time (in ns)
+    double       achieved;  // Open loop: achieved rate (in TX/s)
+    double       p99;       // Open loop: 99th percentile of the response times (in ns)
+};
+
+/** Write a whole buffer to a file descriptor.
+ * @param fd   File descriptor
+ * @param data Buffer
+ * @param size Buffer size
+ * @return Whether the whole buffer has been written
+**/
+static bool write_all(int fd, void const* data, size_t size) noexcept {
+    auto cursor = static_cast<char const*>(data);
+    while (size > 0) {
+        auto res = ::write(fd, cursor, size);
+        if (res < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        cursor += res;
+        size -= static_cast<size_t>(res);
+    }
+    return true;
+}
+
+/** Run a function in a child process, which sends its results back over a pipe; libraries loaded by the function, their threads and their heap die with the child.
+ * @param func    Function to run in the child (int -> int), given the write end of the pipe, returning the exit code of the child
+ * @param timeout Time after which the child gets killed (in ns, 'Chrono::invalid_tick' for none)
+ * @param data    Data written to the pipe by the child (replaced)
+ * @param usage   Resource usage of the child (replaced)
+ * @return Wait status of the child, -1 if killed on timeout
+**/
+template<class Func> static int run_isolated(Func&& func, Chrono::Tick timeout, ::std::string& data, struct ::rusage& usage) {
+    int fds[2];
+    if (::pipe(fds) != 0)
+        throw Exception::Isolation{};
+    ::std::cout.flush(); // Not to be written twice
+    ::std::cerr.flush();
+    auto pid = ::fork();
+    if (pid < 0) {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        throw Exception::Isolation{};
+    }
+    if (pid == 0) { // Child process
+        ::close(fds[0]);
+        auto code = func(fds[1]);
+        ::std::cout.flush();
+        ::std::cerr.flush();
+        ::std::_Exit(code); // Without running the destructors of the parent's state
+    }
+    ::close(fds[1]);
+    data.clear();
+    auto killed = false;
+    Chrono chrono;
+    chrono.start();
+    while (true) {
+        auto wait = -1; // In ms
+        if (timeout != Chrono::invalid_tick) {
+            auto elapsed = chrono.delta();
+            if (elapsed >= timeout) {
+                ::kill(pid, SIGKILL);
+                killed = true;
+                break;
+            }
+            wait = static_cast<int>(::std::min<Chrono::Tick>((timeout - elapsed) / 1000000ul + 1, 1000ul));
+        }
+        struct ::pollfd pfd{fds[0], POLLIN, 0};
+        auto res = ::poll(&pfd, 1, wait);
+        if (res < 0 && errno != EINTR)
+            break;
+        if (res <= 0)
+            continue;
+        char buf[4096];
+        auto size = ::read(fds[0], buf, sizeof(buf));
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size <= 0) // Child done
+            break;
+        data.append(buf, static_cast<size_t>(size));
+    }
+    ::close(fds[0]);
+    int status = 0;
+    while (::wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            ::std::memset(&usage, 0, sizeof(usage));
+            break;
+        }
+    }
+    return killed ? -1 : status;
+}
+
+/** Quote a string for JSON.
+ * @param text Null-terminated string
+ * @return Quoted string
+**/
+static auto json_string(char const* text) {
+    ::std::string res{"\""};
+    for (; *text != '\0'; ++text) {
+        auto c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\') {
+            res += '\\';
+            res += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buf[8];
+            ::std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            res += buf;
+        } else {
+            res += static_cast<char>(c);
+        }
+    }
+    return res + "\"";
+}
+
 // -------------------------------------------------------------------------- //
 
 /** Program entry point.
@@ -248,110 +612,428 @@ static auto measure(Workload& workload, unsigned int const nbthreads, unsigned i
 int main(int argc, char** argv) {
     try {
         // Parse command line option(s)
-        if (argc < 3) {
-            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "grading") << " [--dynamic] <seed> <reference library path> <tested library path>..." << ::std::endl;
-            return 1;
-        }
-        bool dynamic; // Whether to use dynamic memory allocation
-        if (::std::strcmp(argv[1], "--dynamic") == 0) {
-            dynamic = true;
+        bool dynamic = false; // Whether to use dynamic memory allocation
+        bool numa    = false; // Whether to evaluate each library under every NUMA placement policy
+        unsigned long period = 10; // Sampling period of the commits (in ms)
+        ::std::vector<size_t> sweep; // Worker counts to evaluate, CSV output on 'cout' (none for the default count)
+        bool weak = false;           // Whether sweep points keep the per-worker work of the default count, instead of the total work
+        bool json = false;           // Whether to output the results as JSON on 'cout' (instead of CSV for a sweep)
+        ::std::string affinity{"none"}; // Worker placement policy: none, compact, scatter or a processor list
+        ::std::vector<double> rates; // Open-loop aggregate rates to evaluate (in TX/s), CSV output on 'cout' (none for closed loop)
+        bool poisson = true;         // Whether open-loop arrivals are Poisson, instead of evenly spaced
+        Parameters params;
+        while (argc > 1 && ::std::strncmp(argv[1], "--", 2) == 0) {
+            if (::std::strcmp(argv[1], "--dynamic") == 0) {
+                dynamic = true;
+            } else if (::std::strcmp(argv[1], "--numa") == 0) {
+                numa = true;
+            } else if (::std::strcmp(argv[1], "--sweep") == 0 && argc > 2) {
+                sweep = parse_counts(argv[2]);
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else if (::std::strcmp(argv[1], "--weak") == 0) {
+                weak = true;
+            } else if (::std::strcmp(argv[1], "--affinity") == 0 && argc > 2) {
+                affinity = argv[2];
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else if (::std::strcmp(argv[1], "--rates") == 0 && argc > 2) {
+                rates = parse_rates(argv[2]);
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else if (::std::strcmp(argv[1], "--arrivals") == 0 && argc > 2) {
+                if (::std::strcmp(argv[2], "poisson") == 0) {
+                    poisson = true;
+                } else if (::std::strcmp(argv[2], "constant") == 0) {
+                    poisson = false;
+                } else {
+                    throw ::std::invalid_argument{"unknown arrival process '" + ::std::string{argv[2]} + "'"};
+                }
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else if (::std::strcmp(argv[1], "--json") == 0) {
+                json = true;
+            } else if (::std::strcmp(argv[1], "--config") == 0 && argc > 2) {
+                params.load(argv[2]);
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else if (argc > 2 && params.set(argv[1] + 2, argv[2])) {
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else if (::std::strcmp(argv[1], "--period") == 0 && argc > 2) {
+                period = ::std::stoul(argv[2]);
+                if (period == 0)
+                    period = 1;
+                argv[2] = argv[0]; // Pop the value
+                --argc;
+                ++argv;
+            } else {
+                break;
+            }
             { // Pop the argument
                 argv[1] = argv[0];
                 --argc;
                 ++argv;
             }
-        } else {
-            dynamic = false;
+        }
+        if (argc < 3) {
+            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "grading") << " [--dynamic] [--numa] [--period <ms>] [--sweep <counts, e.g. 1-4,8,16> [--weak]] [--rates <TX/s, e.g. 50000,100000> [--arrivals <poisson|constant>]] [--json] [--affinity <none|compact|scatter|cpu list>] [--config <path>] [--txs-per-worker <n>] [--accounts <n>] [--expected-accounts <n>] [--balance <n>] [--prob-long <p>] [--prob-alloc <p>] [--repeats <n>] [--slow-factor <n>] <seed> <reference library path> <tested library path>..." << ::std::endl;
+            return 1;
         }
         // Get/set/compute run parameters
-        auto const nbworkers = []() {
+        auto const nbdefault = []() {
             auto res = ::std::thread::hardware_concurrency();
             if (unlikely(res == 0))
                 res = 16;
             return static_cast<size_t>(res);
         }();
-        auto const nbtxperwrk    = 400000ul / nbworkers;
-        auto const nbaccounts    = 32 * nbworkers;
-        auto const expnbaccounts = 1024 * nbworkers;
-        auto const init_balance  = 100ul;
-        auto const prob_long     = dynamic ? 0.05f : 0.5f;
-        auto const prob_alloc    = dynamic ? 0.2f : 0.f;
-        auto const nbrepeats     = 7;
+        auto const nbtxtotal     = 400000ul;
+        auto const points        = sweep.empty() ? ::std::vector<size_t>{nbdefault} : sweep;
+        auto const offered       = rates.empty() ? ::std::vector<double>{0.} : rates;
+        auto const init_balance  = static_cast<WorkloadBank::Balance>(params.init_balance);
+        auto const prob_long     = params.prob_long >= 0.f ? params.prob_long : dynamic ? 0.05f : 0.5f;
+        auto const prob_alloc    = params.prob_alloc >= 0.f ? params.prob_alloc : dynamic ? 0.2f : 0.f;
+        auto const nbrepeats     = static_cast<unsigned int>(params.nbrepeats);
         auto const seed          = static_cast<Seed>(::std::stoul(argv[1]));
         auto const clk_res       = Chrono::get_resolution();
-        auto const slow_factor   = 100ul;
-        // Print run parameters
-        ::std::cout << "⎧ #worker threads:     " << nbworkers << ::std::endl;
-        ::std::cout << "⎪ #TX per worker:      " << nbtxperwrk << ::std::endl;
-        ::std::cout << "⎪ #repetitions:        " << nbrepeats << ::std::endl;
-        ::std::cout << "⎪ Initial #accounts:   " << nbaccounts << ::std::endl;
-        ::std::cout << "⎪ Expected #accounts:  " << expnbaccounts << ::std::endl;
-        ::std::cout << "⎪ Initial balance:     " << init_balance << ::std::endl;
-        ::std::cout << "⎪ Long TX probability: " << prob_long << ::std::endl;
-        ::std::cout << "⎪ Allocation TX prob.: " << prob_alloc << ::std::endl;
-        ::std::cout << "⎪ Slow trigger factor: " << slow_factor << ::std::endl;
-        ::std::cout << "⎪ Clock resolution:    ";
+        auto const slow_factor   = static_cast<Chrono::Tick>(params.slow_factor);
+        auto const get_nbtxperwrk = [&](size_t nbworkers) -> size_t { // Per-worker values of the parameters depending on the number of workers
+            return params.nbtxperwrk > 0 ? params.nbtxperwrk : nbtxtotal / (weak ? nbdefault : nbworkers);
+        };
+        auto const get_nbaccounts = [&](size_t nbworkers) -> size_t {
+            return params.nbaccounts > 0 ? params.nbaccounts : 32 * nbworkers;
+        };
+        auto const get_expnbaccounts = [&](size_t nbworkers) -> size_t {
+            return params.expnbaccounts > 0 ? params.expnbaccounts : 1024 * nbworkers;
+        };
+        auto const cpus = [&]() { // Processor of each worker, cyclically
+            Topology topology;
+            if (affinity == "none")
+                return ::std::vector<int>{};
+            if (affinity == "compact")
+                return Topology::compact(topology.get_cpus());
+            if (affinity == "scatter")
+                return Topology::scatter(topology.get_cpus());
+            ::std::vector<int> res;
+            for (auto id: parse_counts(affinity.c_str(), 0)) {
+                auto const& usable = topology.get_cpus();
+                if (::std::none_of(usable.begin(), usable.end(), [&](Topology::Cpu const& cpu) { return cpu.id == static_cast<int>(id); }))
+                    throw ::std::invalid_argument{"processor " + ::std::to_string(id) + " is not usable"};
+                res.push_back(static_cast<int>(id));
+            }
+            return res;
+        }();
+        // Print run parameters (on 'cerr' when the CSV of a sweep or the JSON goes to 'cout')
+        auto const csv = (!sweep.empty() || !rates.empty()) && !json;
+        auto& out = csv || json ? ::std::cerr : ::std::cout;
+        out << "⎧ #worker threads:     ";
+        for (size_t point = 0; point < points.size(); ++point)
+            out << (point > 0 ? ", " : "") << points[point];
+        out << ::std::endl;
+        if (sweep.empty()) {
+            out << "⎪ #TX per worker:      " << get_nbtxperwrk(nbdefault) << ::std::endl;
+            out << "⎪ Initial #accounts:   " << get_nbaccounts(nbdefault) << ::std::endl;
+            out << "⎪ Expected #accounts:  " << get_expnbaccounts(nbdefault) << ::std::endl;
+        } else {
+            out << "⎪ #TX per worker:      " << (params.nbtxperwrk > 0 || weak ? ::std::to_string(get_nbtxperwrk(nbdefault)) : ::std::to_string(nbtxtotal) + " / #workers") << ::std::endl;
+            out << "⎪ Initial #accounts:   " << (params.nbaccounts > 0 ? ::std::to_string(params.nbaccounts) : "32 × #workers") << ::std::endl;
+            out << "⎪ Expected #accounts:  " << (params.expnbaccounts > 0 ? ::std::to_string(params.expnbaccounts) : "1024 × #workers") << ::std::endl;
+        }
+        out << "⎪ Offered load:        ";
+        if (rates.empty()) {
+            out << "<closed loop>" << ::std::endl;
+        } else {
+            for (size_t point = 0; point < rates.size(); ++point)
+                out << (point > 0 ? ", " : "") << rates[point];
+            out << " TX/s (" << (poisson ? "Poisson" : "constant") << " arrivals)" << ::std::endl;
+        }
+        out << "⎪ #repetitions:        " << nbrepeats << ::std::endl;
+        out << "⎪ Initial balance:     " << init_balance << ::std::endl;
+        out << "⎪ Long TX probability: " << prob_long << ::std::endl;
+        out << "⎪ Allocation TX prob.: " << prob_alloc << ::std::endl;
+        out << "⎪ Slow trigger factor: " << slow_factor << ::std::endl;
+        out << "⎪ Sampling period:     " << period << " ms" << ::std::endl;
+        out << "⎪ Worker placement:    " << (cpus.empty() ? "<none>" : affinity);
+        if (!cpus.empty()) {
+            out << ", processors";
+            for (auto cpu: cpus)
+                out << " " << cpu;
+            out << " (cyclically)";
+        }
+        out << ::std::endl;
+        out << "⎪ NUMA policies:       " << (numa ? "first-touch, interleave, partition" : "<environment>") << ::std::endl;
+        out << "⎪ Clock resolution:    ";
         if (unlikely(clk_res == Chrono::invalid_tick)) {
-            ::std::cout << "<unknown>" << ::std::endl;
+            out << "<unknown>" << ::std::endl;
         } else {
-            ::std::cout << clk_res << " ns" << ::std::endl;
+            out << clk_res << " ns" << ::std::endl;
         }
-        ::std::cout << "⎩ Seed value:          " << seed << ::std::endl;
-        // Library evaluations
-        double reference = 0.; // Set to avoid irrelevant '-Wmaybe-uninitialized'
-        auto const pertxdiv = static_cast<double>(nbworkers) * static_cast<double>(nbtxperwrk);
-        auto maxtick_init = Chrono::invalid_tick;
-        auto maxtick_perf = Chrono::invalid_tick;
-        auto maxtick_chck = Chrono::invalid_tick;
-        for (auto i = 2; i < argc; ++i) {
-            try {
-                ::std::cout << "⎧ Evaluating '" << argv[i] << "'" << (maxtick_init == Chrono::invalid_tick ? " (reference)" : "") << "..." << ::std::endl;
-                // Prepare measurement (load TM library + initialize workload)
-                TransactionalLibrary tl{argv[i]};
-                WorkloadBank         bank{tl, nbworkers, nbtxperwrk, nbaccounts, expnbaccounts, init_balance, prob_long, prob_alloc};
-                // Actual performance measurements and correctness check
-                try {
-                    auto res = measure(bank, nbworkers, nbrepeats, seed, maxtick_init, maxtick_perf, maxtick_chck);
-                    // Check false negative-free correctness
-                    auto error = ::std::get<0>(res);
-                    if (unlikely(error)) {
-                        ::std::cout << "⎩ " << error << ::std::endl;
-                        return 1;
+        out << "⎩ Seed value:          " << seed << ::std::endl;
+        ::std::ostringstream results; // JSON results of each evaluation
+        auto failed = false;          // Whether an evaluation failed (the others still run)
+        auto const isolation_slack = 10000000000ul; // Time given to a child process besides its measurements, to load the library and report (in ns)
+        auto const saturation_ratio = 0.95; // Fraction of an offered rate to achieve for it to be sustained
+        auto const knee_factor      = 4.;   // Growth of the p99 response time, over the one at the lowest offered rate, that marks the latency knee
+        if (csv)
+            ::std::cout << "policy,threads,tx_per_thread,library,median_ms,throughput_tx_per_s,speedup,attempts,commits,abort_ratio,offered_tx_per_s,achieved_tx_per_s,response_p50_ns,response_p99_ns,response_p999_ns,response_max_ns" << ::std::endl;
+        // Library evaluations, once per NUMA placement policy in benchmark mode ('TM_NUMA_POLICY' is read by the libraries at region creation)
+        char const* const numa_policies[] = {"first-touch", "interleave", "partition"};
+        auto const nbpolicies = numa ? sizeof(numa_policies) / sizeof(*numa_policies) : 1;
+        for (size_t policy = 0; policy < nbpolicies; ++policy) {
+            if (numa) {
+                ::setenv("TM_NUMA_POLICY", numa_policies[policy], 1);
+                out << "NUMA placement policy '" << numa_policies[policy] << "':" << ::std::endl;
+            }
+            for (auto nbworkers: points) {
+                auto const nbtxperwrk    = get_nbtxperwrk(nbworkers);
+                auto const nbaccounts    = get_nbaccounts(nbworkers);
+                auto const expnbaccounts = get_expnbaccounts(nbworkers);
+                if (!sweep.empty())
+                    out << "Worker threads " << nbworkers << ":" << ::std::endl;
+                ::std::vector<::std::vector<OpenLoopPoint>> curves(static_cast<size_t>(argc)); // Open-loop results of each library
+                for (auto rate: offered) { // Open-loop rates (a single closed-loop point if none)
+                    if (!rates.empty())
+                        out << "Offered load " << rate << " TX/s:" << ::std::endl;
+                    double reference = 0.; // Set to avoid irrelevant '-Wmaybe-uninitialized'
+                    auto const pertxdiv = static_cast<double>(nbworkers) * static_cast<double>(nbtxperwrk);
+                    auto maxtick_init = Chrono::invalid_tick;
+                    auto maxtick_perf = Chrono::invalid_tick;
+                    auto maxtick_chck = Chrono::invalid_tick;
+                    for (auto i = 2; i < argc; ++i) {
+                        auto const isref = maxtick_init == Chrono::invalid_tick;
+                        out << "⎧ Evaluating '" << argv[i] << "'" << (isref ? " (reference)" : "") << "..." << ::std::endl;
+                        auto const timeout = isref ? Chrono::invalid_tick : maxtick_init + nbrepeats * maxtick_perf + maxtick_chck + isolation_slack;
+                        ::std::string data;
+                        struct ::rusage usage;
+                        auto status = run_isolated([&](int fd) -> int { // In the child process
+                            try {
+                                // Prepare measurement (load TM library + initialize workload)
+                                TransactionalLibrary tl{argv[i]};
+                                WorkloadBank         bank{tl, nbworkers, nbtxperwrk, nbaccounts, expnbaccounts, init_balance, prob_long, prob_alloc, false, false, 0.f, rate, poisson};
+                                // Actual performance measurements and correctness check
+                                try {
+                                    AbortCounts aborts;
+                                    TransactionCounts counts;
+                                    ::std::unique_ptr<LatencyHistogram[]> latencies{new LatencyHistogram[AbortCounts::nbtypes]};
+                                    ::std::unique_ptr<OpenLoopStats> open{new OpenLoopStats{}};
+                                    ::std::vector<uint_fast64_t> series;
+                                    ::std::vector<Chrono::Tick> repetitions;
+                                    ::std::unique_ptr<PerfCounters> counters;
+                                    auto res = measure(bank, nbworkers, nbrepeats, seed, maxtick_init, maxtick_perf, maxtick_chck, aborts, counts, latencies.get(), *open, period * 1000000ul, series, repetitions, counters, cpus);
+                                    // Check false negative-free correctness
+                                    auto error = ::std::get<0>(res);
+                                    if (unlikely(error)) {
+                                        out << "⎪ " << error << ::std::endl;
+                                        return 1;
+                                    }
+                                    // Print results
+                                    auto tick_init = ::std::get<1>(res);
+                                    auto tick_perf = ::std::get<2>(res);
+                                    auto tick_chck = ::std::get<3>(res);
+                                    auto perfdbl = static_cast<double>(tick_perf);
+                                    auto const refperf = isref ? perfdbl : reference;
+                                    out << "⎪ Total user execution time: " << (perfdbl / 1000000.) << " ms";
+                                    if (!isref) // Compare with reference performance
+                                        out << " -> " << (refperf / perfdbl) << " speedup";
+                                    out << ::std::endl;
+                                    for (uint32_t type = 0; type < TransactionCounts::nbtypes; ++type) { // Attempts by type, over the whole evaluation
+                                        auto attempts = counts.get_attempts(type);
+                                        if (attempts == 0)
+                                            continue;
+                                        out << "⎪ Committed " << WorkloadBank::type_name(type) << " TX: " << counts.get_commits(type) << " / " << attempts << " attempts" << ::std::endl;
+                                    }
+                                    for (uint32_t type = 0; type < AbortCounts::nbtypes; ++type) { // Aborts by type, over the whole evaluation
+                                        if (aborts.get(type) == 0)
+                                            continue;
+                                        out << "⎪ Aborted " << WorkloadBank::type_name(type) << " TX: " << aborts.get(type) << " (";
+                                        auto first = true;
+                                        for (size_t reason = 0; reason < AbortCounts::nbreasons; ++reason) {
+                                            auto count = aborts.get(type, static_cast<STM::Abort>(reason));
+                                            if (count == 0)
+                                                continue;
+                                            out << (first ? "" : ", ") << AbortCounts::reason_name(static_cast<STM::Abort>(reason)) << ": " << count;
+                                            first = false;
+                                        }
+                                        out << ")" << ::std::endl;
+                                    }
+                                    auto to_ns = [](uint_fast64_t ticks) { return static_cast<uint_fast64_t>(static_cast<double>(ticks) / Stamp::per_ns()); };
+                                    for (uint32_t type = 0; type < AbortCounts::nbtypes; ++type) { // Latencies by type, from the first attempt to the commit
+                                        auto const& latency = latencies[type];
+                                        if (latency.get_count() == 0)
+                                            continue;
+                                        out << "⎪ Latency of " << WorkloadBank::type_name(type) << " TX: p50 " << to_ns(latency.get_percentile(50.)) << " ns, p90 " << to_ns(latency.get_percentile(90.)) << " ns, p99 " << to_ns(latency.get_percentile(99.)) << " ns, p99.9 " << to_ns(latency.get_percentile(99.9)) << " ns, max " << to_ns(latency.get_max()) << " ns" << ::std::endl;
+                                    }
+                                    auto const responses = open->get_responses(); // Open loop only
+                                    auto const achieved  = open->ticks > 0 ? static_cast<double>(open->issued) * static_cast<double>(nbworkers) * 1000000000. * Stamp::per_ns() / static_cast<double>(open->ticks) : 0.; // Issued over the mean time of a worker
+                                    if (rate > 0.) {
+                                        out << "⎪ Offered load: " << rate << " TX/s (" << (poisson ? "Poisson" : "constant") << " arrivals), achieved " << achieved << " TX/s" << ::std::endl;
+                                        for (uint32_t type = 0; type < OpenLoopStats::nbtypes; ++type) { // Response times by type, from the scheduled start to the commit
+                                            auto const& response = open->responses[type];
+                                            if (response.get_count() == 0)
+                                                continue;
+                                            out << "⎪ Response time of " << WorkloadBank::type_name(type) << " TX: p50 " << to_ns(response.get_percentile(50.)) << " ns, p90 " << to_ns(response.get_percentile(90.)) << " ns, p99 " << to_ns(response.get_percentile(99.)) << " ns, p99.9 " << to_ns(response.get_percentile(99.9)) << " ns, max " << to_ns(response.get_max()) << " ns" << ::std::endl;
+                                        }
+                                    }
+                                    out << "⎪ Commits per " << period << " ms (median repetition):";
+                                    for (auto commits: series)
+                                        out << " " << commits;
+                                    out << ::std::endl;
+                                    auto const nbperftxs = pertxdiv * static_cast<double>(nbrepeats); // Transactions committed while counting
+                                    if (counters->is_available()) {
+                                        out << "⎪ Hardware counters per TX:";
+                                        for (size_t event = 0; event < PerfCounters::nbevents; ++event) {
+                                            if (counters->has(event))
+                                                out << " " << PerfCounters::get_name(event) << " " << (counters->get(event) / nbperftxs);
+                                        }
+                                        out << ::std::endl;
+                                    } else {
+                                        out << "⎪ Hardware counters: unavailable (" << counters->get_error() << ")" << ::std::endl;
+                                    }
+                                    out << "⎪ Average TX execution time: " << (perfdbl / pertxdiv) << " ns" << ::std::endl;
+                                    uint_fast64_t attempts = 0; // Over the whole evaluation
+                                    uint_fast64_t commits  = 0;
+                                    for (uint32_t type = 0; type < TransactionCounts::nbtypes; ++type) {
+                                        attempts += counts.get_attempts(type);
+                                        commits  += counts.get_commits(type);
+                                    }
+                                    ::std::ostringstream fragment; // JSON object of the evaluation, without its closing brace
+                                    if (json) {
+                                        fragment << "{\"policy\":" << json_string(numa ? numa_policies[policy] : "environment") << ",\"threads\":" << nbworkers << ",\"txs_per_worker\":" << nbtxperwrk << ",\"accounts\":" << nbaccounts << ",\"expected_accounts\":" << expnbaccounts << ",\"library\":" << json_string(argv[i]) << ",\"reference\":" << (i == 2 ? "true" : "false") << ",\"times_ns\":[";
+                                        for (size_t repetition = 0; repetition < repetitions.size(); ++repetition)
+                                            fragment << (repetition > 0 ? "," : "") << repetitions[repetition];
+                                        fragment << "],\"median_ns\":" << tick_perf << ",\"min_ns\":" << *::std::min_element(repetitions.begin(), repetitions.end()) << ",\"max_ns\":" << *::std::max_element(repetitions.begin(), repetitions.end()) << ",\"init_ns\":" << tick_init << ",\"check_ns\":" << tick_chck << ",\"speedup\":" << (refperf / perfdbl) << ",\"attempts\":" << attempts << ",\"commits\":" << commits << ",\"counters_per_tx\":";
+                                        if (counters->is_available()) {
+                                            fragment << "{";
+                                            auto first = true;
+                                            for (size_t event = 0; event < PerfCounters::nbevents; ++event) {
+                                                if (!counters->has(event))
+                                                    continue;
+                                                fragment << (first ? "" : ",") << json_string(PerfCounters::get_name(event)) << ":" << (counters->get(event) / nbperftxs);
+                                                first = false;
+                                            }
+                                            fragment << "}";
+                                        } else {
+                                            fragment << "null";
+                                        }
+                                        if (rate > 0.) {
+                                            fragment << ",\"offered_tx_per_s\":" << rate << ",\"achieved_tx_per_s\":" << achieved << ",\"response_ns\":{\"p50\":" << to_ns(responses.get_percentile(50.)) << ",\"p90\":" << to_ns(responses.get_percentile(90.)) << ",\"p99\":" << to_ns(responses.get_percentile(99.)) << ",\"p99.9\":" << to_ns(responses.get_percentile(99.9)) << ",\"max\":" << to_ns(responses.get_max()) << "}";
+                                        } else {
+                                            fragment << ",\"offered_tx_per_s\":null,\"achieved_tx_per_s\":null,\"response_ns\":null";
+                                        }
+                                    } else if (csv) { // One CSV row per library and point
+                                        ::std::cout << (numa ? numa_policies[policy] : "environment") << "," << nbworkers << "," << nbtxperwrk << "," << argv[i] << "," << (perfdbl / 1000000.) << "," << (pertxdiv / perfdbl * 1000000000.) << "," << (refperf / perfdbl) << "," << attempts << "," << commits << "," << (attempts > 0 ? static_cast<double>(attempts - commits) / static_cast<double>(attempts) : 0.) << ",";
+                                        if (rate > 0.) {
+                                            ::std::cout << rate << "," << achieved << "," << to_ns(responses.get_percentile(50.)) << "," << to_ns(responses.get_percentile(99.)) << "," << to_ns(responses.get_percentile(99.9)) << "," << to_ns(responses.get_max()) << ::std::endl;
+                                        } else {
+                                            ::std::cout << ",,,,," << ::std::endl;
+                                        }
+                                    }
+                                    Report report{tick_init, tick_perf, tick_chck, achieved, static_cast<double>(to_ns(responses.get_percentile(99.)))};
+                                    auto text = fragment.str();
+                                    if (!write_all(fd, &report, sizeof(report)) || !write_all(fd, text.data(), text.size()))
+                                        return 1;
+                                    return 0;
+                                } catch (Exception::BoundedOverrun const& err) { // Special case: cannot unload library with running threads, so print error and quick-exit
+                                    ::std::cerr << "⎪ *** EXCEPTION - main thread ***" << ::std::endl;
+                                    ::std::cerr << "⎪ " << err.what() << ::std::endl;
+                                    ::std::cerr.flush();
+                                    ::std::_Exit(2);
+                                }
+                            } catch (::std::exception const& err) {
+                                ::std::cerr << "⎪ *** EXCEPTION - main thread ***" << ::std::endl;
+                                ::std::cerr << "⎪ " << err.what() << ::std::endl;
+                                return 1;
+                            }
+                        }, timeout, data, usage);
+                        auto const maxrss = static_cast<unsigned long>(usage.ru_maxrss); // In KiB
+                        if (status == 0 && data.size() >= sizeof(Report)) {
+                            Report report;
+                            ::std::memcpy(&report, data.data(), sizeof(report));
+                            if (isref) { // Set reference performance
+                                maxtick_init = slow_factor * report.tick_init;
+                                if (unlikely(maxtick_init == Chrono::invalid_tick)) // Bad luck...
+                                    ++maxtick_init;
+                                maxtick_perf = slow_factor * report.tick_perf;
+                                if (unlikely(maxtick_perf == Chrono::invalid_tick)) // Bad luck...
+                                    ++maxtick_perf;
+                                maxtick_chck = slow_factor * report.tick_chck;
+                                if (unlikely(maxtick_chck == Chrono::invalid_tick)) // Bad luck...
+                                    ++maxtick_chck;
+                                reference = static_cast<double>(report.tick_perf);
+                            }
+                            if (rate > 0.)
+                                curves[i].push_back(OpenLoopPoint{rate, report.achieved, report.p99});
+                            out << "⎩ Peak resident set size: " << maxrss << " KiB" << ::std::endl;
+                            if (json)
+                                results << (results.tellp() > 0 ? "," : "") << data.substr(sizeof(Report)) << ",\"peak_rss_kib\":" << maxrss << "}";
+                            continue;
+                        }
+                        if (status < 0) {
+                            out << "⎩ Killed after " << (timeout / 1000000ul) << " ms";
+                        } else if (WIFSIGNALED(status)) {
+                            out << "⎩ Terminated by signal " << WTERMSIG(status);
+                        } else {
+                            out << "⎩ Failed";
+                        }
+                        out << " (peak resident set size: " << maxrss << " KiB)" << ::std::endl;
+                        failed = true;
+                        if (isref) // Nothing to compare with
+                            return 1;
                     }
-                    // Print results
-                    auto tick_init = ::std::get<1>(res);
-                    auto tick_perf = ::std::get<2>(res);
-                    auto tick_chck = ::std::get<3>(res);
-                    auto perfdbl = static_cast<double>(tick_perf);
-                    ::std::cout << "⎪ Total user execution time: " << (perfdbl / 1000000.) << " ms";
-                    if (maxtick_init == Chrono::invalid_tick) { // Set reference performance
-                        maxtick_init = slow_factor * tick_init;
-                        if (unlikely(maxtick_init == Chrono::invalid_tick)) // Bad luck...
-                            ++maxtick_init;
-                        maxtick_perf = slow_factor * tick_perf;
-                        if (unlikely(maxtick_perf == Chrono::invalid_tick)) // Bad luck...
-                            ++maxtick_perf;
-                        maxtick_chck = slow_factor * tick_chck;
-                        if (unlikely(maxtick_chck == Chrono::invalid_tick)) // Bad luck...
-                            ++maxtick_chck;
-                        reference = perfdbl;
-                    } else { // Compare with reference performance
-                        ::std::cout << " -> " << (reference / perfdbl) << " speedup";
+                }
+                if (!rates.empty()) { // Saturation point and latency knee of each library, over the offered rates
+                    for (auto i = 2; i < argc; ++i) {
+                        auto& curve = curves[i];
+                        out << "⎧ Open-loop summary of '" << argv[i] << "':" << ::std::endl;
+                        if (curve.empty()) {
+                            out << "⎩ No successful evaluation" << ::std::endl;
+                            continue;
+                        }
+                        ::std::sort(curve.begin(), curve.end(), [](OpenLoopPoint const& a, OpenLoopPoint const& b) { return a.offered < b.offered; });
+                        double sustained = 0.; // Highest offered rate achieved within the saturation ratio
+                        double peak      = 0.; // Highest achieved rate
+                        for (auto const& point: curve) {
+                            if (point.achieved >= saturation_ratio * point.offered)
+                                sustained = point.offered;
+                            peak = ::std::max(peak, point.achieved);
+                        }
+                        out << "⎪ Highest sustained rate: ";
+                        if (sustained > 0.) {
+                            out << sustained << " TX/s" << ::std::endl;
+                        } else {
+                            out << "<none>" << ::std::endl;
+                        }
+                        out << "⎪ Peak achieved rate: " << peak << " TX/s" << ::std::endl;
+                        auto knee = ::std::find_if(curve.begin(), curve.end(), [&](OpenLoopPoint const& point) { return point.p99 > knee_factor * curve.front().p99; });
+                        out << "⎩ Latency knee: ";
+                        if (knee != curve.end()) {
+                            out << knee->offered << " TX/s (p99 response time " << static_cast<uint_fast64_t>(knee->p99) << " ns, " << (knee->p99 / curve.front().p99) << "× that at " << curve.front().offered << " TX/s)" << ::std::endl;
+                        } else {
+                            out << "not reached (p99 response time within " << knee_factor << "× that at " << curve.front().offered << " TX/s)" << ::std::endl;
+                        }
                     }
-                    ::std::cout << ::std::endl;
-                    ::std::cout << "⎩ Average TX execution time: " << (perfdbl / pertxdiv) << " ns" << ::std::endl;
-                } catch (Exception::BoundedOverrun const& err) { // Special case: cannot unload library with running threads, so print error and quick-exit
-                    ::std::cerr << "⎪ *** EXCEPTION - main thread ***" << ::std::endl;
-                    ::std::cerr << "⎩ " << err.what() << ::std::endl;
-                    ::std::abort();
                 }
-            } catch (::std::exception const& err) {
-                ::std::cerr << "⎪ *** EXCEPTION - main thread ***" << ::std::endl;
-                ::std::cerr << "⎩ " << err.what() << ::std::endl;
-                return 1;
             }
         }
-        return 0;
+        if (json) {
+            ::std::cout << "{\"parameters\":{\"seed\":" << seed << ",\"dynamic\":" << (dynamic ? "true" : "false") << ",\"threads\":[";
+            for (size_t point = 0; point < points.size(); ++point)
+                ::std::cout << (point > 0 ? "," : "") << points[point];
+            ::std::cout << "],\"weak\":" << (weak ? "true" : "false") << ",\"rates\":[";
+            for (size_t point = 0; point < rates.size(); ++point)
+                ::std::cout << (point > 0 ? "," : "") << rates[point];
+            ::std::cout << "],\"arrivals\":" << (rates.empty() ? "null" : poisson ? "\"poisson\"" : "\"constant\"") << ",\"affinity\":" << json_string(affinity.c_str()) << ",\"cpus\":[";
+            for (size_t cpu = 0; cpu < cpus.size(); ++cpu)
+                ::std::cout << (cpu > 0 ? "," : "") << cpus[cpu];
+            ::std::cout << "],\"balance\":" << init_balance << ",\"prob_long\":" << prob_long << ",\"prob_alloc\":" << prob_alloc << ",\"repeats\":" << nbrepeats << ",\"slow_factor\":" << slow_factor << ",\"clock_resolution_ns\":" << (clk_res == Chrono::invalid_tick ? 0 : clk_res) << "},\"results\":[" << results.str() << "]}" << ::std::endl;
+        }
+        return failed ? 1 : 0;
     } catch (::std::exception const& err) {
         ::std::cerr << "⎧ *** EXCEPTION - main thread ***" << ::std::endl << "⎩ " << err.what() << ::std::endl;
         return 1;
@@ -0,0 +1,203 @@
+/**
+ * @file   perf.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Hardware performance counters of the worker threads.
+**/
+
+#pragma once
+
+// External headers
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+extern "C" {
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+}
+
+// Internal headers
+#include "common.hpp"
+
+// -------------------------------------------------------------------------- //
+
+/** Hardware performance counters of a set of threads, one counter group per thread (user-space only, so that 'perf_event_paranoid' up to 2 permits them).
+ * Events the processor (or the hypervisor) does not provide are skipped; without even cycles, no counter is available.
+**/
+class PerfCounters final: private NonCopyable {
+public:
+    constexpr static size_t nbevents = 5; // Number of events
+private:
+    /** Event description.
+    **/
+    struct Event {
+        char const* name; // Display name
+        uint32_t type;    // 'perf_event_attr::type'
+        uint64_t config;  // 'perf_event_attr::config'
+    };
+    /** Get the description of an event.
+     * @param event Event index
+     * @return Event description
+    **/
+    static Event const& describe(size_t event) noexcept {
+        static Event const events[nbevents] = {
+            {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}, // Group leader
+            {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {"L1D misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {"LLC misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {"branch misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+        };
+        return events[event];
+    }
+    /** Open an event counter.
+     * @param event  Event index
+     * @param tid    Thread to count
+     * @param leader Group leader descriptor (-1 to open one)
+     * @return Descriptor, -1 on failure (with 'errno' set)
+    **/
+    static int open(size_t event, pid_t tid, int leader) noexcept {
+        struct ::perf_event_attr attr;
+        ::std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = describe(event).type;
+        attr.config         = describe(event).config;
+        attr.disabled       = leader < 0 ? 1 : 0; // Members follow their leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, tid, -1, leader, 0));
+    }
+private:
+    ::std::vector<int> fds;      // Descriptors of each thread, in group order, the leader first
+    size_t nbopened;             // Number of descriptors of each thread
+    bool opened[nbevents];       // Whether each event is counted
+    double totals[nbevents];     // Counts accumulated by each measurement (scaled if multiplexed)
+    ::std::string error;         // Why no counter is available (empty if some are)
+public:
+    /** Open constructor, counters stopped.
+     * @param tids      Threads to count
+     * @param nbthreads Number of threads
+    **/
+    PerfCounters(pid_t const* tids, size_t nbthreads): nbopened{0}, opened{}, totals{} {
+        for (size_t thread = 0; thread < nbthreads; ++thread) {
+            int leader = -1;
+            for (size_t event = 0; event < nbevents; ++event) {
+                if (thread > 0 && !opened[event]) // Events are the same for every thread
+                    continue;
+                auto fd = open(event, tids[thread], leader);
+                if (fd < 0) {
+                    if (thread > 0 || event == 0) { // Mandatory, give up
+                        error = ::std::string{"perf_event_open: "} + ::std::strerror(errno) + " (event '" + describe(event).name + "')";
+                        close();
+                        return;
+                    }
+                    continue;
+                }
+                if (thread == 0) {
+                    opened[event] = true;
+                    ++nbopened;
+                }
+                if (leader < 0)
+                    leader = fd;
+                fds.push_back(fd);
+            }
+        }
+    }
+    /** Close destructor.
+    **/
+    ~PerfCounters() {
+        close();
+    }
+private:
+    /** Close the counters, none available afterwards.
+    **/
+    void close() noexcept {
+        for (auto fd: fds)
+            ::close(fd);
+        fds.clear();
+        nbopened = 0;
+        for (size_t event = 0; event < nbevents; ++event)
+            opened[event] = false;
+    }
+public:
+    /** Check whether counters are available.
+     * @return Whether counters are available
+    **/
+    bool is_available() const noexcept {
+        return nbopened > 0;
+    }
+    /** Get why no counter is available.
+     * @return Null-terminated error message (empty if some are available)
+    **/
+    char const* get_error() const noexcept {
+        return error.c_str();
+    }
+    /** Check whether an event is counted.
+     * @param event Event index
+     * @return Whether the event is counted
+    **/
+    bool has(size_t event) const noexcept {
+        return opened[event];
+    }
+    /** Get the name of an event.
+     * @param event Event index
+     * @return Constant null-terminated name
+    **/
+    static char const* get_name(size_t event) noexcept {
+        return describe(event).name;
+    }
+    /** Get the accumulated count of an event.
+     * @param event Event index
+     * @return Accumulated count
+    **/
+    double get(size_t event) const noexcept {
+        return totals[event];
+    }
+    /** Reset and start the counters of every thread.
+    **/
+    void start() noexcept {
+        for (size_t i = 0; i < fds.size(); i += nbopened) {
+            ::ioctl(fds[i], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(fds[i], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+    /** Stop the counters of every thread, and accumulate their counts.
+    **/
+    void stop() noexcept {
+        for (size_t i = 0; i < fds.size(); i += nbopened)
+            ::ioctl(fds[i], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for (size_t i = 0; i < fds.size(); i += nbopened) {
+            uint64_t buf[3 + nbevents]; // Number of counters, time enabled, time running, then the values
+            auto size = ::read(fds[i], buf, sizeof(buf));
+            if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buf[0] != nbopened || buf[2] == 0) // Not scheduled at all
+                continue;
+            auto scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]); // Multiplexed groups count part of the time
+            size_t value = 3;
+            for (size_t event = 0; event < nbevents; ++event) {
+                if (opened[event])
+                    totals[event] += static_cast<double>(buf[value++]) * scale;
+            }
+        }
+    }
+};
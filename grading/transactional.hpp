@@ -24,6 +24,8 @@
 #pragma once
 
 // External headers
+#include <algorithm>
+#include <type_traits>
 extern "C" {
 #include <dlfcn.h>
 #include <limits.h>
@@ -32,6 +34,7 @@ extern "C" {
 // Internal headers
 namespace STM {
 #include <tm.hpp>
+#include <tm_ext.hpp>
 }
 #include "common.hpp"
 
@@ -45,6 +48,7 @@ EXCEPTION(Path, Any, "path exception");
 EXCEPTION(Module, Any, "transaction library exception");
     EXCEPTION(ModuleLoading, Module, "unable to load a transaction library");
     EXCEPTION(ModuleSymbol, Module, "symbol not found in loaded libraries");
+    EXCEPTION(ModuleExtension, Module, "optional extension not provided by the transaction library");
 EXCEPTION(Transaction, Any, "transaction manager exception");
     EXCEPTION(TransactionAlign, Transaction, "incorrect alignment detected before transactional operation");
     EXCEPTION(TransactionReadOnly, Transaction, "tried to write/alloc/free using a read-only transaction");
@@ -80,6 +84,19 @@ private:
     using FnWrite   = decltype(&STM::tm_write);
     using FnAlloc   = decltype(&STM::tm_alloc);
     using FnFree    = decltype(&STM::tm_free);
+    using FnSnapshot = decltype(&STM::tm_snapshot);
+    using FnReadRange  = decltype(&STM::tm_read_range);
+    using FnWriteRange = decltype(&STM::tm_write_range);
+    using FnReadV      = decltype(&STM::tm_readv);
+    using FnWriteV     = decltype(&STM::tm_writev);
+    using FnRelease    = decltype(&STM::tm_release);
+    using FnRun        = decltype(&STM::tm_run);
+    using FnFetchAdd    = decltype(&STM::tm_fetch_add);
+    using FnCompareSwap = decltype(&STM::tm_compare_swap);
+    using FnSwap        = decltype(&STM::tm_swap);
+    using FnBeginHinted = decltype(&STM::tm_begin_hinted);
+    using FnSiteStats   = decltype(&STM::tm_get_site_stats);
+    using FnLastAbort   = decltype(&STM::tm_last_abort);
 private:
     void*     module;     // Module opaque handler
     FnCreate  tm_create;  // Module's initialization function
@@ -93,6 +110,19 @@ private:
     FnWrite   tm_write;   // Module's shared memory write function
     FnAlloc   tm_alloc;   // Module's shared memory allocation function
     FnFree    tm_free;    // Module's shared memory freeing function
+    FnSnapshot tm_snapshot; // Module's online snapshot function (optional, null if not provided)
+    FnReadRange  tm_read_range;  // Module's bulk read function (optional, null if not provided)
+    FnWriteRange tm_write_range; // Module's bulk write function (optional, null if not provided)
+    FnReadV      tm_readv;       // Module's vectored read function (optional, null if not provided)
+    FnWriteV     tm_writev;      // Module's vectored write function (optional, null if not provided)
+    FnRelease    tm_release;     // Module's early release function (optional, null if not provided)
+    FnRun        tm_run;         // Module's transaction runner (optional, null if not provided)
+    FnFetchAdd    tm_fetch_add;    // Module's single-word fetch-and-add (optional, null if not provided)
+    FnCompareSwap tm_compare_swap; // Module's single-word compare-and-swap (optional, null if not provided)
+    FnSwap        tm_swap;         // Module's single-word swap (optional, null if not provided)
+    FnBeginHinted tm_begin_hinted; // Module's transaction begin function with hints (optional, null if not provided)
+    FnSiteStats   tm_get_site_stats;   // Module's per-site statistics query function (optional, null if not provided)
+    FnLastAbort   tm_last_abort;   // Module's abort diagnostics query function (optional, null if not provided)
 private:
     /** Solve a symbol from its name, and bind it to the given function.
      * @param name Name of the symbol to resolve
@@ -107,6 +137,14 @@ private:
     template<class Signature> void solve(char const* name, Signature& func) const {
         func = solve<Signature>(name);
     }
+    /** Solve an optional symbol from its name, and bind it to the given function (null if not found).
+     * @param name Name of the symbol to resolve
+     * @param func Target function to bind
+    **/
+    template<class Signature> void solve_optional(char const* name, Signature& func) const {
+        auto res = ::dlsym(module, name);
+        func = res ? *reinterpret_cast<Signature*>(&res) : nullptr;
+    }
 public:
     /** Loader constructor.
      * @param path  Path to the library to load
@@ -133,6 +171,65 @@ public:
             solve("tm_alloc", tm_alloc);
             solve("tm_free", tm_free);
         }
+        { // Bind module's optional extensions
+            solve_optional("tm_snapshot", tm_snapshot);
+            solve_optional("tm_read_range", tm_read_range);
+            solve_optional("tm_write_range", tm_write_range);
+            solve_optional("tm_readv", tm_readv);
+            solve_optional("tm_writev", tm_writev);
+            solve_optional("tm_release", tm_release);
+            solve_optional("tm_run", tm_run);
+            solve_optional("tm_fetch_add", tm_fetch_add);
+            solve_optional("tm_compare_swap", tm_compare_swap);
+            solve_optional("tm_swap", tm_swap);
+            solve_optional("tm_begin_hinted", tm_begin_hinted);
+            solve_optional("tm_get_site_stats", tm_get_site_stats);
+            solve_optional("tm_last_abort", tm_last_abort);
+        }
+    }
+    /** Check whether the library provides online snapshots.
+     * @return Whether 'tm_snapshot' is available
+    **/
+    auto has_snapshot() const noexcept {
+        return tm_snapshot != nullptr;
+    }
+    /** Check whether the library provides early release.
+     * @return Whether 'tm_release' is available
+    **/
+    auto has_release() const noexcept {
+        return tm_release != nullptr;
+    }
+    /** Check whether the library provides a transaction runner.
+     * @return Whether 'tm_run' is available
+    **/
+    auto has_run() const noexcept {
+        return tm_run != nullptr;
+    }
+    /** Check whether the library provides single-word read-modify-write operations.
+     * @return Whether 'tm_fetch_add', 'tm_compare_swap' and 'tm_swap' are all available
+    **/
+    auto has_rmw() const noexcept {
+        return tm_fetch_add != nullptr && tm_compare_swap != nullptr && tm_swap != nullptr;
+    }
+    /** Check whether the library takes transaction hints.
+     * @return Whether 'tm_begin_hinted' is available
+    **/
+    auto has_hints() const noexcept {
+        return tm_begin_hinted != nullptr;
+    }
+    /** Create a shared memory region on the calling thread, without the time bound of 'TransactionalMemory'.
+     * @param size  Size of the first shared segment (in bytes)
+     * @param align Alignment of the shared memory region (in bytes)
+     * @return Opaque shared memory region handle, 'STM::invalid_shared' on failure
+    **/
+    auto create(size_t size, size_t align) const noexcept {
+        return tm_create(size, align);
+    }
+    /** Destroy a shared memory region created with 'create', on the calling thread.
+     * @param shared Shared memory region to destroy
+    **/
+    void destroy(STM::shared_t shared) const noexcept {
+        tm_destroy(shared);
     }
     /** Unloader destructor.
     **/
@@ -163,16 +260,18 @@ private:
     void*  start_addr; // Shared memory region first segment's start address
     size_t start_size; // Shared memory region first segment's size (in bytes)
     size_t alignment;  // Shared memory region alignment (in bytes)
+    ::std::chrono::milliseconds side_time; // Maximum waiting time for initialization/clean-up
 public:
     /** Bind constructor.
-     * @param library Transactional library to use
-     * @param align   Shared memory region required alignment
-     * @param size    Size of the shared memory region to allocate
+     * @param library   Transactional library to use
+     * @param align     Shared memory region required alignment
+     * @param size      Size of the shared memory region to allocate
+     * @param side_time Maximum waiting time for initialization/clean-up (optional)
     **/
-    TransactionalMemory(TransactionalLibrary const& library, size_t align, size_t size): tl{library}, start_size{size}, alignment{align} {
+    TransactionalMemory(TransactionalLibrary const& library, size_t align, size_t size, ::std::chrono::milliseconds side_time = max_side_time): tl{library}, start_size{size}, alignment{align}, side_time{side_time} {
         if (unlikely(assert_mode && (!is_power_of_two(align) || size % align != 0)))
             throw Exception::TransactionAlign{};
-        bounded_run(max_side_time, [&]() {
+        bounded_run(side_time, [&]() {
             shared = tl.tm_create(size, align);
             if (unlikely(shared == STM::invalid_shared))
                 throw Exception::TransactionCreate{};
@@ -182,7 +281,7 @@ public:
     /** Unbind destructor.
     **/
     ~TransactionalMemory() noexcept {
-        bounded_run(max_side_time, [&]() {
+        bounded_run(side_time, [&]() {
             tl.tm_destroy(shared);
         }, "transactional library takes too long during transaction memory destruction");
     }
@@ -213,6 +312,35 @@ public:
     auto begin(bool ro) const noexcept {
         return tl.tm_begin(shared, ro);
     }
+    /** [thread-safe] Begin a new transaction on the shared memory region with hints, a plain 'begin' if the library takes no hints.
+     * @param ro    Whether the transaction is read-only
+     * @param hints Hints for the transaction (optional)
+     * @return Opaque transaction ID, 'STM::invalid_tx' on failure
+    **/
+    auto begin(bool ro, STM::tm_hints const* hints) const noexcept {
+        if (tl.tm_begin_hinted)
+            return tl.tm_begin_hinted(shared, ro, hints);
+        return tl.tm_begin(shared, ro);
+    }
+    /** [thread-safe] Get the statistics of the transactions begun with a given site ID.
+     * @param site  Site ID
+     * @param stats Statistics to fill
+     * @return Whether the library keeps statistics for the site
+    **/
+    auto site_stats(uint32_t site, STM::tm_site_stats* stats) const noexcept {
+        if (tl.tm_get_site_stats)
+            return tl.tm_get_site_stats(shared, site, stats);
+        return false;
+    }
+    /** [thread-safe] Get the diagnostics of the last transaction of the calling thread that aborted.
+     * @param info Diagnostics to fill
+     * @return Whether the library provides them and a transaction of the calling thread aborted so far
+    **/
+    auto last_abort(STM::tm_abort_info* info) const noexcept {
+        if (tl.tm_last_abort)
+            return tl.tm_last_abort(info);
+        return false;
+    }
     /** [thread-safe] End the given transaction.
      * @param tx Opaque transaction ID
      * @return Whether the whole transaction is a success
@@ -257,6 +385,157 @@ public:
     auto free(TX tx, void* target) const noexcept {
         return tl.tm_free(shared, tx, target);
     }
+    /** [thread-safe] Bulk read operation in the given transaction, a plain 'read' of the whole range if the library has no bulk read.
+     * @param tx     Transaction to use
+     * @param source Source start address
+     * @param size   Source/target range
+     * @param target Target start address
+     * @return Whether the whole transaction can continue
+    **/
+    auto read_range(TX tx, void const* source, size_t size, void* target) const noexcept {
+        if (tl.tm_read_range)
+            return tl.tm_read_range(shared, tx, source, size, target);
+        return tl.tm_read(shared, tx, source, size, target);
+    }
+    /** [thread-safe] Bulk write operation in the given transaction, a plain 'write' of the whole range if the library has no bulk write.
+     * @param tx     Transaction to use
+     * @param source Source start address
+     * @param size   Source/target range
+     * @param target Target start address
+     * @return Whether the whole transaction can continue
+    **/
+    auto write_range(TX tx, void const* source, size_t size, void* target) const noexcept {
+        if (tl.tm_write_range)
+            return tl.tm_write_range(shared, tx, source, size, target);
+        return tl.tm_write(shared, tx, source, size, target);
+    }
+    /** [thread-safe] Vectored read operation in the given transaction, one 'read' per element if the library has no vectored read.
+     * @param tx    Transaction to use
+     * @param vecs  Elements to read (shared source, private target and size each)
+     * @param count Number of elements
+     * @return Whether the whole transaction can continue
+    **/
+    auto readv(TX tx, STM::tm_vec const* vecs, size_t count) const noexcept {
+        if (tl.tm_readv)
+            return tl.tm_readv(shared, tx, vecs, count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!tl.tm_read(shared, tx, vecs[i].shared, vecs[i].size, vecs[i].local))
+                return false;
+        }
+        return true;
+    }
+    /** [thread-safe] Vectored write operation in the given transaction, one 'write' per element if the library has no vectored write.
+     * @param tx    Transaction to use
+     * @param vecs  Elements to write (shared target, private source and size each)
+     * @param count Number of elements
+     * @return Whether the whole transaction can continue
+    **/
+    auto writev(TX tx, STM::tm_vec const* vecs, size_t count) const noexcept {
+        if (tl.tm_writev)
+            return tl.tm_writev(shared, tx, vecs, count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!tl.tm_write(shared, tx, vecs[i].local, vecs[i].size, vecs[i].shared))
+                return false;
+        }
+        return true;
+    }
+    /** [thread-safe] Early release in the given transaction, a no-op if the library has no early release.
+     * @param tx      Transaction to use
+     * @param address Start address of the released range
+     * @param size    Size of the released range
+     * @return Whether the whole transaction can continue
+    **/
+    auto release(TX tx, void const* address, size_t size) const noexcept {
+        if (tl.tm_release)
+            return tl.tm_release(shared, tx, address, size);
+        return true;
+    }
+    /** [thread-safe] Run a transaction to commit, retried by the library if it provides a runner, else right away by this function.
+     * @param ro       Whether the transaction is read-only
+     * @param body     Transaction body, returning 'false' as soon as an operation failed
+     * @param context  Opaque context passed to the body
+     * @param attempts Number of attempts made (optional)
+     * @return Whether the transaction committed ('false' only if one could not be begun)
+    **/
+    auto run(bool ro, STM::tm_body_t body, void* context, size_t* attempts = nullptr) const noexcept {
+        if (tl.tm_run)
+            return tl.tm_run(shared, ro, body, context, attempts);
+        size_t count = 0;
+        while (true) {
+            ++count;
+            auto tx = tl.tm_begin(shared, ro);
+            if (unlikely(tx == STM::invalid_tx))
+                return false;
+            if (body(shared, tx, context) && tl.tm_end(shared, tx))
+                break;
+        }
+        if (attempts)
+            *attempts = count;
+        return true;
+    }
+private:
+    /** Single-word read-modify-write as a full transaction, for libraries without the dedicated operations.
+     * @param address Address of the word in shared memory
+     * @param op      New value from the current one (uint64_t -> uint64_t)
+     * @return Value of the word before the operation
+    **/
+    template<class Op> uint64_t read_modify_write(void* address, Op&& op) const noexcept {
+        while (true) {
+            auto tx = tl.tm_begin(shared, false);
+            if (unlikely(tx == STM::invalid_tx))
+                continue;
+            uint64_t previous;
+            if (!tl.tm_read(shared, tx, address, sizeof(previous), &previous))
+                continue;
+            auto value = op(previous);
+            if (value != previous && !tl.tm_write(shared, tx, &value, sizeof(value), address))
+                continue;
+            if (tl.tm_end(shared, tx))
+                return previous;
+        }
+    }
+public:
+    /** [thread-safe] Atomically add to a word, as a transaction of its own.
+     * @param address Address of the word in shared memory
+     * @param delta   Value to add
+     * @return Value of the word before the operation
+    **/
+    auto fetch_add(void* address, uint64_t delta) const noexcept {
+        if (tl.tm_fetch_add)
+            return tl.tm_fetch_add(shared, address, delta);
+        return read_modify_write(address, [&](uint64_t current) { return current + delta; });
+    }
+    /** [thread-safe] Atomically replace a word if it holds the expected value, as a transaction of its own.
+     * @param address  Address of the word in shared memory
+     * @param expected Expected value
+     * @param desired  Value to write if the expected value is there
+     * @return Value of the word before the operation (the swap happened iff equal to 'expected')
+    **/
+    auto compare_swap(void* address, uint64_t expected, uint64_t desired) const noexcept {
+        if (tl.tm_compare_swap)
+            return tl.tm_compare_swap(shared, address, expected, desired);
+        return read_modify_write(address, [&](uint64_t current) { return current == expected ? desired : current; });
+    }
+    /** [thread-safe] Atomically replace a word, as a transaction of its own.
+     * @param address Address of the word in shared memory
+     * @param value   Value to write
+     * @return Value of the word before the operation
+    **/
+    auto swap(void* address, uint64_t value) const noexcept {
+        if (tl.tm_swap)
+            return tl.tm_swap(shared, address, value);
+        return read_modify_write(address, [&](uint64_t) { return value; });
+    }
+    /** [thread-safe] Stream a consistent snapshot of the region while transactions keep running.
+     * @param sink    Output callback, called with consecutive pieces of the stream
+     * @param context Opaque context passed to the sink
+     * @return Whether the whole snapshot was streamed
+    **/
+    auto snapshot(STM::tm_sink_t sink, void* context) const {
+        if (unlikely(!tl.has_snapshot()))
+            throw Exception::ModuleExtension{};
+        return tl.tm_snapshot(shared, sink, context);
+    }
 };
 
 /** One transaction over a shared memory region management class.
@@ -287,6 +566,15 @@ public:
         if (unlikely(tx == STM::invalid_tx))
             throw Exception::TransactionBegin{};
     }
+    /** Begin constructor with hints.
+     * @param tm    Transactional memory to bind
+     * @param ro    Whether the transaction is read-only
+     * @param hints Hints for the transaction
+    **/
+    Transaction(TransactionalMemory const& tm, Mode ro, STM::tm_hints const& hints): tm{tm}, tx{tm.begin(static_cast<bool>(ro), &hints)}, aborted{false}, is_ro{static_cast<bool>(ro)} {
+        if (unlikely(tx == STM::invalid_tx))
+            throw Exception::TransactionBegin{};
+    }
     /** End destructor.
     **/
     ~Transaction() noexcept(false) {
@@ -327,6 +615,62 @@ public:
             throw Exception::TransactionRetry{};
         }
     }
+    /** [thread-safe] Bulk read operation in the bound transaction, for large contiguous ranges.
+     * @param source Source start address
+     * @param size   Source/target range
+     * @param target Target start address
+    **/
+    void read_range(void const* source, size_t size, void* target) {
+        if (unlikely(!tm.read_range(tx, source, size, target))) {
+            aborted = true;
+            throw Exception::TransactionRetry{};
+        }
+    }
+    /** [thread-safe] Bulk write operation in the bound transaction, for large contiguous ranges.
+     * @param source Source start address
+     * @param size   Source/target range
+     * @param target Target start address
+    **/
+    void write_range(void const* source, size_t size, void* target) {
+        if (unlikely(assert_mode && is_ro))
+            throw Exception::TransactionReadOnly{};
+        if (unlikely(!tm.write_range(tx, source, size, target))) {
+            aborted = true;
+            throw Exception::TransactionRetry{};
+        }
+    }
+    /** [thread-safe] Vectored read operation in the bound transaction, equivalent to reading each element in order.
+     * @param vecs  Elements to read (shared source, private target and size each)
+     * @param count Number of elements
+    **/
+    void readv(STM::tm_vec const* vecs, size_t count) {
+        if (unlikely(!tm.readv(tx, vecs, count))) {
+            aborted = true;
+            throw Exception::TransactionRetry{};
+        }
+    }
+    /** [thread-safe] Vectored write operation in the bound transaction, equivalent to writing each element in order.
+     * @param vecs  Elements to write (shared target, private source and size each)
+     * @param count Number of elements
+    **/
+    void writev(STM::tm_vec const* vecs, size_t count) {
+        if (unlikely(assert_mode && is_ro))
+            throw Exception::TransactionReadOnly{};
+        if (unlikely(!tm.writev(tx, vecs, count))) {
+            aborted = true;
+            throw Exception::TransactionRetry{};
+        }
+    }
+    /** [thread-safe] Early release in the bound transaction: the previous reads within the range are no longer validated.
+     * @param address Start address of the released range
+     * @param size    Size of the released range
+    **/
+    void release(void const* address, size_t size) {
+        if (unlikely(!tm.release(tx, address, size))) {
+            aborted = true;
+            throw Exception::TransactionRetry{};
+        }
+    }
     /** [thread-safe] Memory allocation operation in the bound transaction, throw if no memory available.
      * @param size Size to allocate
      * @return Target start address
@@ -406,6 +750,11 @@ public:
     void operator=(Type const& source) const {
         return write(source);
     }
+    /** Early release of the previous reads of the entry.
+    **/
+    void release() const {
+        tx.release(address, sizeof(Type));
+    }
 public:
     /** Address of the first byte after the entry.
      * @return First byte after the entry
@@ -476,6 +825,11 @@ public:
         tx.free(read());
         write(nullptr);
     }
+    /** Early release of the previous reads of the entry.
+    **/
+    void release() const {
+        tx.release(address, sizeof(Type*));
+    }
 public:
     /** Address of the first byte after the entry.
      * @return First byte after the entry
@@ -521,7 +875,25 @@ public:
      * @param source Private content to write at the shared address
     **/
     void write(size_t index, Type const& source) const {
-        tx.write(tx, &source, sizeof(Type), address + index);
+        tx.write(&source, sizeof(Type), address + index);
+    }
+    /** Bulk read operation.
+     * @param index  Index of the first cell to read
+     * @param count  Number of cells to read
+     * @param target Private array of (at least) 'count' cells
+    **/
+    void read(size_t index, size_t count, Type* target) const {
+        if (count > 0)
+            tx.read_range(address + index, count * sizeof(Type), target);
+    }
+    /** Bulk write operation.
+     * @param index  Index of the first cell to write
+     * @param count  Number of cells to write
+     * @param source Private array of (at least) 'count' cells
+    **/
+    void write(size_t index, size_t count, Type const* source) const {
+        if (count > 0)
+            tx.write_range(source, count * sizeof(Type), address + index);
     }
 public:
     /** Reference a cell.
@@ -580,7 +952,7 @@ public:
     void write(size_t index, Type const& source) const {
         if (unlikely(assert_mode && index >= n))
             throw Exception::SharedOverflow{};
-        tx.write(tx, &source, sizeof(Type), address + index);
+        tx.write(&source, sizeof(Type), address + index);
     }
 public:
     /** Reference a cell.
@@ -602,19 +974,353 @@ public:
 
 // -------------------------------------------------------------------------- //
 
-/** Repeat a given transaction until it commits.
+/** Number of aborted attempts in 'transactional' and 'transactional_run' by the calling thread.
+**/
+static thread_local uint_fast64_t transactional_aborts = 0;
+
+/** Aborted attempts by transaction type and reason.
+**/
+class AbortCounts final {
+public:
+    constexpr static size_t nbtypes   = 8; // Number of transaction types (higher ones are folded)
+    constexpr static size_t nbreasons = 7; // Number of reasons, 'STM::Abort::none' standing for an unknown reason
+private:
+    uint_fast64_t counts[nbtypes][nbreasons]; // Aborts by type and reason
+public:
+    /** Zero constructor.
+    **/
+    AbortCounts() noexcept: counts{} {}
+public:
+    /** Get the name of a reason.
+     * @param reason Reason
+     * @return Constant null-terminated name
+    **/
+    static char const* reason_name(STM::Abort reason) noexcept {
+        char const* const names[nbreasons] = {"unknown", "read locked", "read version", "commit locked", "commit validation", "out of memory", "invalid operation"};
+        auto index = static_cast<size_t>(reason);
+        return index < nbreasons ? names[index] : "unknown";
+    }
+    /** Count one abort.
+     * @param type   Transaction type
+     * @param reason Reason of the abort
+    **/
+    void add(uint32_t type, STM::Abort reason) noexcept {
+        auto index = static_cast<size_t>(reason);
+        ++counts[type % nbtypes][index < nbreasons ? index : 0];
+    }
+    /** Add the counts of another instance.
+     * @param other Other instance
+     * @return Current instance
+    **/
+    AbortCounts& operator+=(AbortCounts const& other) noexcept {
+        for (size_t type = 0; type < nbtypes; ++type) {
+            for (size_t reason = 0; reason < nbreasons; ++reason)
+                counts[type][reason] += other.counts[type][reason];
+        }
+        return *this;
+    }
+    /** Get the number of aborts of a type for a reason.
+     * @param type   Transaction type
+     * @param reason Reason
+     * @return Number of aborts
+    **/
+    auto get(uint32_t type, STM::Abort reason) const noexcept {
+        return counts[type % nbtypes][static_cast<size_t>(reason) % nbreasons];
+    }
+    /** Get the number of aborts of a type.
+     * @param type Transaction type
+     * @return Number of aborts, for any reason
+    **/
+    auto get(uint32_t type) const noexcept {
+        uint_fast64_t total = 0;
+        for (size_t reason = 0; reason < nbreasons; ++reason)
+            total += counts[type % nbtypes][reason];
+        return total;
+    }
+};
+
+/** Aborted attempts in 'transactional' by the calling thread, by transaction type and reason (as reported by the library).
+**/
+static thread_local AbortCounts transactional_abort_counts;
+
+/** Attempts and retries by transaction type, counted by the harness alone: each instance is updated by a single thread, and can be read by the others meanwhile.
+**/
+class TransactionCounts final {
+public:
+    constexpr static size_t nbtypes = AbortCounts::nbtypes; // Number of transaction types (higher ones are folded)
+private:
+    ::std::atomic<uint_fast64_t> attempts[nbtypes]; // Begun attempts by type
+    ::std::atomic<uint_fast64_t> retries[nbtypes];  // Aborted attempts by type
+private:
+    /** Increment a counter of the owning thread (no read-modify-write needed).
+     * @param counter Counter to increment
+     * @param count   Increment
+    **/
+    static void bump(::std::atomic<uint_fast64_t>& counter, uint_fast64_t count = 1) noexcept {
+        counter.store(counter.load(::std::memory_order_relaxed) + count, ::std::memory_order_relaxed);
+    }
+public:
+    /** Zero constructor.
+    **/
+    TransactionCounts() noexcept {
+        for (size_t type = 0; type < nbtypes; ++type) {
+            attempts[type].store(0, ::std::memory_order_relaxed);
+            retries[type].store(0, ::std::memory_order_relaxed);
+        }
+    }
+public:
+    /** [owning thread] Count attempts.
+     * @param type  Transaction type
+     * @param count Number of attempts (optional)
+    **/
+    void attempt(uint32_t type, uint_fast64_t count = 1) noexcept {
+        bump(attempts[type % nbtypes], count);
+    }
+    /** [owning thread] Count aborted attempts.
+     * @param type  Transaction type
+     * @param count Number of aborted attempts (optional)
+    **/
+    void retry(uint32_t type, uint_fast64_t count = 1) noexcept {
+        bump(retries[type % nbtypes], count);
+    }
+    /** [owning thread] Add the counts of another instance.
+     * @param other Other instance
+     * @return Current instance
+    **/
+    TransactionCounts& operator+=(TransactionCounts const& other) noexcept {
+        for (size_t type = 0; type < nbtypes; ++type) {
+            bump(attempts[type], other.attempts[type].load(::std::memory_order_relaxed));
+            bump(retries[type], other.retries[type].load(::std::memory_order_relaxed));
+        }
+        return *this;
+    }
+    /** [thread-safe] Get the number of attempts of a type.
+     * @param type Transaction type
+     * @return Number of attempts
+    **/
+    uint_fast64_t get_attempts(uint32_t type) const noexcept {
+        return attempts[type % nbtypes].load(::std::memory_order_relaxed);
+    }
+    /** [thread-safe] Get the number of commits of a type, i.e. the attempts that did not abort (or are running).
+     * @param type Transaction type
+     * @return Number of commits
+    **/
+    uint_fast64_t get_commits(uint32_t type) const noexcept {
+        auto aborted = retries[type % nbtypes].load(::std::memory_order_relaxed);
+        return attempts[type % nbtypes].load(::std::memory_order_relaxed) - aborted;
+    }
+    /** [thread-safe] Get the number of commits of every type.
+     * @return Number of commits
+    **/
+    uint_fast64_t get_commits() const noexcept {
+        uint_fast64_t total = 0;
+        for (size_t type = 0; type < nbtypes; ++type)
+            total += get_commits(type);
+        return total;
+    }
+};
+
+/** Attempts in 'transactional' and 'transactional_run' by the calling thread, by transaction type.
+**/
+static thread_local TransactionCounts transactional_counts;
+
+/** Log-linear ("HDR") latency histogram: values below 2^precision are exact, the others are within 1/2^precision of their bucket.
+**/
+class LatencyHistogram final {
+public:
+    constexpr static unsigned int precision = 5;                                // Bits of sub-buckets per power of two
+    constexpr static unsigned int nbranges  = 40;                               // Powers of two above the exact values (larger values are folded)
+    constexpr static size_t nbbuckets = (nbranges + 1) << precision;            // Number of buckets
+private:
+    uint_fast64_t counts[nbbuckets]; // Values by bucket
+    uint_fast64_t total;             // Number of values
+    uint_fast64_t max;               // Largest value
+private:
+    /** Get the bucket of a value.
+     * @param value Value
+     * @return Bucket index
+    **/
+    static size_t bucket(uint_fast64_t value) noexcept {
+        if (value < (1ul << precision))
+            return value;
+        auto range = static_cast<unsigned int>(63 - __builtin_clzll(value)) - precision + 1; // Position of the leading bit above the exact values
+        if (unlikely(range > nbranges))
+            return nbbuckets - 1;
+        return (range << precision) + ((value >> (range - 1)) & ((1ul << precision) - 1));
+    }
+    /** Get the middle value of a bucket.
+     * @param index Bucket index
+     * @return Middle value
+    **/
+    static uint_fast64_t middle(size_t index) noexcept {
+        if (index < (1ul << precision))
+            return index;
+        auto range = index >> precision;
+        auto low = ((1ul << precision) + (index & ((1ul << precision) - 1))) << (range - 1);
+        return low + (1ul << (range - 1)) / 2;
+    }
+public:
+    /** Zero constructor.
+    **/
+    LatencyHistogram() noexcept: counts{}, total{0}, max{0} {}
+public:
+    /** Record a value.
+     * @param value Value
+    **/
+    void record(uint_fast64_t value) noexcept {
+        ++counts[bucket(value)];
+        ++total;
+        if (value > max)
+            max = value;
+    }
+    /** Add the values of another instance.
+     * @param other Other instance
+     * @return Current instance
+    **/
+    LatencyHistogram& operator+=(LatencyHistogram const& other) noexcept {
+        for (size_t i = 0; i < nbbuckets; ++i)
+            counts[i] += other.counts[i];
+        total += other.total;
+        if (other.max > max)
+            max = other.max;
+        return *this;
+    }
+    /** Get the number of values.
+     * @return Number of values
+    **/
+    auto get_count() const noexcept {
+        return total;
+    }
+    /** Get the largest value.
+     * @return Largest value (0 if none)
+    **/
+    auto get_max() const noexcept {
+        return max;
+    }
+    /** Get a percentile.
+     * @param percent Percentile, in [0, 100]
+     * @return Value such that the given percent of the values are not larger, within the precision (0 if none)
+    **/
+    uint_fast64_t get_percentile(double percent) const noexcept {
+        auto rank = static_cast<uint_fast64_t>(percent / 100. * static_cast<double>(total) + 0.5);
+        if (rank == 0)
+            rank = 1;
+        uint_fast64_t seen = 0;
+        for (size_t i = 0; i < nbbuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank)
+                return ::std::min(middle(i), max);
+        }
+        return max;
+    }
+};
+
+/** Latencies (in 'Stamp' ticks) in 'transactional' by the calling thread, by transaction type, from the begin of the first attempt to the commit.
+**/
+static thread_local LatencyHistogram transactional_latencies[AbortCounts::nbtypes];
+
+/** Records the latency of a transaction when leaving its 'transactional' call, unless by an exception.
+**/
+class LatencyRecorder final: private NonCopyable {
+private:
+    uint32_t const type;     // Transaction type
+    Stamp::Tick const start; // Time stamp of the begin of the first attempt
+public:
+    /** Start constructor.
+     * @param type Transaction type
+    **/
+    LatencyRecorder(uint32_t type) noexcept: type{type}, start{Stamp::now()} {}
+    /** Record destructor.
+    **/
+    ~LatencyRecorder() {
+        if (likely(!::std::uncaught_exception()))
+            transactional_latencies[type % AbortCounts::nbtypes].record(Stamp::now() - start);
+    }
+};
+
+/** Count an aborted attempt of the calling thread.
  * @param tm   Transactional memory
- * @param mode Transactional mode
- * @param func Transaction closure (Transaction& -> ...)
+ * @param type Transaction type
+**/
+static void transactional_count_abort(TransactionalMemory const& tm, uint32_t type) noexcept {
+    ++transactional_aborts;
+    transactional_counts.retry(type);
+    STM::tm_abort_info info;
+    transactional_abort_counts.add(type, tm.last_abort(&info) ? info.reason : STM::Abort::none);
+}
+
+/** Repeat a given transaction until it commits, counting its attempts, aborts and latency under the given type.
+ * @param tm    Transactional memory
+ * @param type  Transaction type, for the counts
+ * @param begin Attempt runner (Func& -> ...), beginning a transaction and running the closure on it
+ * @param func  Transaction closure (Transaction& -> ...)
  * @return Returned value (or void) when the transaction committed
 **/
-template<class Func> static auto transactional(TransactionalMemory const& tm, Transaction::Mode mode, Func&& func) {
+template<class Begin, class Func> static auto transactional_repeat(TransactionalMemory const& tm, uint32_t type, Begin&& begin, Func&& func) {
+    LatencyRecorder recorder{type};
     do {
+        transactional_counts.attempt(type);
         try {
-            Transaction tx{tm, mode};
-            return func(tx);
+            return begin(func);
         } catch (Exception::TransactionRetry const&) {
+            transactional_count_abort(tm, type);
             continue;
         }
     } while (true);
 }
+
+/** Repeat a given transaction of a given type until it commits.
+ * @param tm   Transactional memory
+ * @param mode Transactional mode
+ * @param type Transaction type, for the abort counts
+ * @param func Transaction closure (Transaction& -> ...)
+ * @return Returned value (or void) when the transaction committed
+**/
+template<class Func> static auto transactional(TransactionalMemory const& tm, Transaction::Mode mode, uint32_t type, Func&& func) {
+    return transactional_repeat(tm, type, [&](auto& body) {
+        Transaction tx{tm, mode};
+        return body(tx);
+    }, func);
+}
+
+/** Repeat a given transaction until it commits, each attempt begun with the given hints.
+ * @param tm    Transactional memory
+ * @param mode  Transactional mode
+ * @param hints Hints for each attempt, the site ID being the transaction type
+ * @param func  Transaction closure (Transaction& -> ...)
+ * @return Returned value (or void) when the transaction committed
+**/
+template<class Func> static auto transactional(TransactionalMemory const& tm, Transaction::Mode mode, STM::tm_hints const& hints, Func&& func) {
+    return transactional_repeat(tm, hints.site, [&](auto& body) {
+        Transaction tx{tm, mode, hints};
+        return body(tx);
+    }, func);
+}
+
+/** Repeat a given transaction until it commits.
+ * @param tm   Transactional memory
+ * @param mode Transactional mode
+ * @param func Transaction closure (Transaction& -> ...)
+ * @return Returned value (or void) when the transaction committed
+**/
+template<class Func> static auto transactional(TransactionalMemory const& tm, Transaction::Mode mode, Func&& func) {
+    return transactional(tm, mode, uint32_t{0}, ::std::forward<Func>(func));
+}
+
+/** Run a given transaction until it commits, without exceptions: retries are made by the library ('tm_run') if it provides a runner.
+ * @param tm   Transactional memory
+ * @param mode Transactional mode
+ * @param func Transaction closure (TransactionalMemory::TX -> bool), must not throw, returning 'false' as soon as an operation on the transaction failed
+**/
+template<class Func> static void transactional_run(TransactionalMemory const& tm, Transaction::Mode mode, Func&& func) {
+    auto body = [](STM::shared_t, STM::tx_t tx, void* context) noexcept -> bool {
+        return (*static_cast<typename ::std::remove_reference<Func>::type*>(context))(tx);
+    };
+    size_t attempts = 0;
+    if (unlikely(!tm.run(static_cast<bool>(mode), body, const_cast<void*>(static_cast<void const*>(&func)), &attempts)))
+        throw Exception::TransactionBegin{};
+    transactional_aborts += attempts - 1;
+    transactional_counts.attempt(0, attempts);
+    transactional_counts.retry(0, attempts - 1);
+}
+
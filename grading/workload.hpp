@@ -24,8 +24,11 @@
 #pragma once
 
 // External headers
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <random>
+#include <utility>
 
 // Internal headers
 #include "common.hpp"
@@ -60,6 +63,13 @@ public:
     /** Virtual destructor.
     **/
     virtual ~Workload() {};
+public:
+    /** Get the transactional memory the workload runs on.
+     * @return Bound transactional memory
+    **/
+    auto const& get_tm() const noexcept {
+        return tm;
+    }
 public:
     /** Shared memory (re)initialization.
      * @return Constant null-terminated error message, 'nullptr' for none
@@ -81,6 +91,46 @@ public:
 
 // -------------------------------------------------------------------------- //
 
+/** Open-loop statistics of a worker, or of several once added.
+**/
+class OpenLoopStats final {
+public:
+    constexpr static size_t nbtypes = AbortCounts::nbtypes; // Number of transaction types (higher ones are folded)
+public:
+    LatencyHistogram responses[nbtypes]; // Response times (in 'Stamp' ticks) by transaction type, from the scheduled start to the commit
+    Stamp::Tick      ticks;              // Time spent in open-loop runs (in 'Stamp' ticks), from the first scheduled start to the last commit
+    uint_fast64_t    issued;             // Number of scheduled transactions
+public:
+    /** Zero constructor.
+    **/
+    OpenLoopStats() noexcept: ticks{0}, issued{0} {}
+public:
+    /** Add the statistics of another instance.
+     * @param other Other instance
+     * @return Current instance
+    **/
+    OpenLoopStats& operator+=(OpenLoopStats const& other) noexcept {
+        for (size_t type = 0; type < nbtypes; ++type)
+            responses[type] += other.responses[type];
+        ticks  += other.ticks;
+        issued += other.issued;
+        return *this;
+    }
+    /** Get the response times of every type.
+     * @return Merged histogram
+    **/
+    LatencyHistogram get_responses() const noexcept {
+        LatencyHistogram res;
+        for (size_t type = 0; type < nbtypes; ++type)
+            res += responses[type];
+        return res;
+    }
+};
+
+/** Open-loop statistics of the 'run's of the calling worker.
+**/
+static thread_local OpenLoopStats workload_open_loop;
+
 /** Bank workload class.
 **/
 class WorkloadBank final: public Workload {
@@ -140,6 +190,11 @@ private:
     Balance init_balance;  // Initial account balance
     float   prob_long;     // Probability of running a long, read-only control transaction
     float   prob_alloc;    // Probability of running an allocation/deallocation transaction, knowing a long transaction won't run
+    bool    early_release; // Whether transfers early-release the traversal of the segments holding neither account
+    bool    hinted;        // Whether transactions are begun with hints (expected sizes and site IDs)
+    float   skew;          // Skew of the account selection of transfers, in [0, 1) (0 for uniform)
+    double  interval;      // Mean time between the scheduled starts of the transactions of a worker (in 'Stamp' ticks), 0 for closed loop
+    bool    poisson;       // Whether the scheduled starts are Poisson arrivals, instead of evenly spaced
     Barrier barrier;       // Barrier for thread synchronization during 'check'
 public:
     /** Bank workload constructor.
@@ -151,15 +206,52 @@ public:
      * @param init_balance  Initial account balance
      * @param prob_long     Probability of running a long, read-only control transaction
      * @param prob_alloc    Probability of running an allocation/deallocation transaction, knowing a long transaction won't run
+     * @param early_release Whether transfers early-release the traversal of the segments holding neither account (optional)
+     * @param hinted        Whether transactions are begun with hints, of site IDs 'site_long', 'site_alloc' and 'site_short' (optional)
+     * @param skew          Skew of the account selection of transfers, in [0, 1): account 'count * u^(1 / (1 - skew))' for u uniform in [0, 1) (optional, uniform by default)
+     * @param rate          Open loop: aggregate rate at which transactions are scheduled, over all the workers (in TX/s), 0 for closed loop (optional, closed loop by default)
+     * @param poisson       Whether the scheduled starts in open loop are Poisson arrivals, instead of evenly spaced (optional, Poisson by default, as in grading)
     **/
-    WorkloadBank(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbaccounts, size_t expnbaccounts, Balance init_balance, float prob_long, float prob_alloc): Workload{library, AccountSegment::align(), AccountSegment::size(nbaccounts)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbaccounts{nbaccounts}, expnbaccounts{expnbaccounts}, init_balance{init_balance}, prob_long{prob_long}, prob_alloc{prob_alloc}, barrier{static_cast<Barrier::Counter>(nbworkers)} {}
+    WorkloadBank(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbaccounts, size_t expnbaccounts, Balance init_balance, float prob_long, float prob_alloc, bool early_release = false, bool hinted = false, float skew = 0.f, double rate = 0., bool poisson = true): Workload{library, AccountSegment::align(), AccountSegment::size(nbaccounts)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbaccounts{nbaccounts}, expnbaccounts{expnbaccounts}, init_balance{init_balance}, prob_long{prob_long}, prob_alloc{prob_alloc}, early_release{early_release}, hinted{hinted}, skew{skew}, interval{rate > 0. ? static_cast<double>(nbworkers) / rate * 1000000000. * Stamp::per_ns() : 0.}, poisson{poisson}, barrier{static_cast<Barrier::Counter>(nbworkers)} {}
+public:
+    /** Transaction types, also the site IDs of the transactions when begun with hints (0 for the others).
+    **/
+    constexpr static uint32_t site_long  = 1;
+    constexpr static uint32_t site_alloc = 2;
+    constexpr static uint32_t site_short = 3;
+    /** Get the name of a transaction type.
+     * @param type Transaction type
+     * @return Constant null-terminated name
+    **/
+    static char const* type_name(uint32_t type) noexcept {
+        switch (type) {
+            case site_long:  return "long";
+            case site_alloc: return "alloc";
+            case site_short: return "short";
+            default:         return "other";
+        }
+    }
 private:
+    /** Repeat a transaction of the given type traversing the (expected) segments until it commits, begun with hints if so configured.
+     * @param mode   Transactional mode
+     * @param site   Transaction type and site ID
+     * @param reads  Expected number of reads besides the traversal
+     * @param writes Expected number of writes
+     * @param func   Transaction closure (Transaction& -> ...)
+     * @return Returned value (or void) when the transaction committed
+    **/
+    template<class Func> auto typed(Transaction::Mode mode, uint32_t site, size_t reads, size_t writes, Func&& func) const {
+        if (!hinted)
+            return transactional(tm, mode, site, ::std::forward<Func>(func));
+        auto nbsegments = expnbaccounts / nbaccounts + 1;
+        return transactional(tm, mode, STM::tm_hints{3 * nbsegments + reads, writes, 0, site}, ::std::forward<Func>(func));
+    }
     /** Long read-only transaction, summing the balance of each account.
      * @param count Loosely-updated number of accounts
      * @return Whether no inconsistency has been found
     **/
     bool long_tx(size_t& nbaccounts) const {
-        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+        return typed(Transaction::Mode::read_only, site_long, expnbaccounts, 0, [&](Transaction& tx) {
             auto count = 0ul;
             auto sum   = Balance{0};
             auto start = tm.get_start();
@@ -188,7 +280,7 @@ private:
      * @param trigger Trigger level that will decide whether to allocate or deallocate
     **/
     void alloc_tx(size_t trigger) const {
-        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+        return typed(Transaction::Mode::read_write, site_alloc, 2, 4, [&](Transaction& tx) {
             auto count = 0ul;
             void* prev = nullptr;
             auto start = tm.get_start();
@@ -234,17 +326,20 @@ private:
      * @return Whether the parameters were satisfying and the transaction committed on useful work
     **/
     bool short_tx(size_t send_id, size_t recv_id) const {
-        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+        return typed(Transaction::Mode::read_write, site_short, 2, 2, [&](Transaction& tx) {
             void* send_ptr = nullptr;
             void* recv_ptr = nullptr;
+            void* link_ptr = nullptr; // Pointer leading to the current segment (none for the first)
             // Get the account pointers in shared memory
             auto start = tm.get_start();
             while (true) {
                 AccountSegment segment{tx, start};
                 size_t segment_count = segment.count;
+                auto holds_account = false;
                 if (!send_ptr) {
                     if (send_id < segment_count) {
                         send_ptr = segment.accounts[send_id].get();
+                        holds_account = true;
                         if (recv_ptr)
                             break;
                     } else {
@@ -254,6 +349,7 @@ private:
                 if (!recv_ptr) {
                     if (recv_id < segment_count) {
                         recv_ptr = segment.accounts[recv_id].get();
+                        holds_account = true;
                         if (send_ptr)
                             break;
                     } else {
@@ -263,6 +359,14 @@ private:
                 start = segment.next;
                 if (!start) // Current segment is the last segment
                     return false; // At least one account does not exist => do nothing
+                if (early_release && !holds_account) {
+                    // Any transfer is fine if accounts shift: only the segments holding the accounts (reached
+                    // through the pointer to them, whose reads are kept) must not be deallocated meanwhile
+                    segment.count.release();
+                    if (link_ptr)
+                        Shared<AccountSegment*>{tx, link_ptr}.release();
+                }
+                link_ptr = segment.next.get();
             }
             // Transfer the money if enough fund
             Shared<Balance> sender{tx, send_ptr};
@@ -296,17 +400,45 @@ public:
         ::std::bernoulli_distribution long_dist{prob_long};
         ::std::bernoulli_distribution alloc_dist{prob_alloc};
         ::std::gamma_distribution<float> alloc_trigger(expnbaccounts, 1);
+        // Open loop: each transaction is scheduled independently of the completion of the previous ones, and its response time
+        // is measured from its scheduled start, so that the time spent queued behind a slow transaction is accounted for
+        ::std::minstd_rand arrival_engine{~seed}; // Separate stream, for the same transactions in closed and open loop
+        ::std::exponential_distribution<double> arrival_dist{interval > 0. ? 1. / interval : 1.};
+        auto const first = Stamp::now();
+        auto scheduled = static_cast<double>(first);
         size_t count = nbaccounts;
         for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
+            uint32_t type;
+            if (interval > 0.) { // Wait for the scheduled start, if not late already
+                while (static_cast<double>(Stamp::now()) < scheduled)
+                    short_pause();
+            }
             if (long_dist(engine)) { // Do a long transaction
+                type = site_long;
                 if (unlikely(!long_tx(count)))
                     return "Violated isolation or atomicity 1";
             } else if (alloc_dist(engine)) { // Do an allocation transaction
+                type = site_alloc;
                 alloc_tx(alloc_trigger(engine));
+            } else if (skew > 0.f) { // Do a short transaction, between mostly low accounts
+                type = site_short;
+                ::std::uniform_real_distribution<double> uniform{0., 1.};
+                auto const exponent = 1. / (1. - skew);
+                auto account = [&]() { return ::std::min(static_cast<size_t>(count * ::std::pow(uniform(engine), exponent)), count - 1); };
+                while (unlikely(!short_tx(account(), account())));
             } else { // Do a short transaction
+                type = site_short;
                 ::std::uniform_int_distribution<size_t> account{0, count - 1};
                 while (unlikely(!short_tx(account(engine), account(engine))));
             }
+            if (interval > 0.) { // Next start scheduled from the previous one, never from the commit
+                workload_open_loop.responses[type].record(Stamp::now() - static_cast<Stamp::Tick>(scheduled));
+                scheduled += poisson ? arrival_dist(arrival_engine) : interval;
+            }
+        }
+        if (interval > 0.) {
+            workload_open_loop.ticks += Stamp::now() - first;
+            workload_open_loop.issued += nbtxperwrk;
         }
         { // Last long transaction
             size_t dummy;
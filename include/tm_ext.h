@@ -0,0 +1,180 @@
+/**
+ * @file   tm_ext.h
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Optional extensions to the interface of "tm.h" (C version). A library may
+ * export any subset of them: callers resolve them with 'dlsym' and fall back
+ * to the base interface when they are missing.
+ *
+ * Durable regions (libraries supporting them create one when TM_DURABLE_PATH
+ * is set) only persist the first segment: 'tm_alloc' returns 'nomem_alloc'
+ * and 'tm_free' fails on them, so that no committed state can point to memory
+ * that would not survive a restart.
+**/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tm.h"
+
+// -------------------------------------------------------------------------- //
+
+/** Snapshot output callback, called with consecutive pieces of the stream.
+ * @param context Opaque context given to 'tm_snapshot'
+ * @param data    Piece of the stream
+ * @param size    Size of the piece (in bytes)
+ * @return Whether the piece was consumed, 'false' cancels the snapshot
+**/
+typedef bool (*tm_sink_t)(void*, void const*, size_t);
+
+/** Header preceding each segment in a snapshot stream, the first segment comes first.
+**/
+typedef struct tm_snapshot_segment {
+    uint64_t offset; // Offset of the segment from the start of the first segment
+    uint64_t size;   // Size of the segment (in bytes), followed by its content
+} tm_snapshot_segment_t;
+
+// -------------------------------------------------------------------------- //
+
+bool tm_snapshot(shared_t, tm_sink_t, void*);
+
+/** Bulk counterparts of 'tm_read'/'tm_write' for large contiguous ranges:
+ * same contract, but the range is validated as a whole, copied at once and
+ * recorded as a single entry, and a range read sees the overlapping writes
+ * of the transaction.
+**/
+bool tm_read_range(shared_t, tx_t, void const*, size_t, void*);
+bool tm_write_range(shared_t, tx_t, void const*, size_t, void*);
+
+/** Element of a scatter-gather access, same constraints as a 'tm_read'/'tm_write'.
+**/
+typedef struct tm_vec {
+    void*  shared; // Address in shared memory
+    void*  local;  // Private buffer (target of a read, source of a write)
+    size_t size;   // Size of the access (in bytes)
+} tm_vec_t;
+
+/** Vectored counterparts of 'tm_read'/'tm_write': equivalent to accessing each
+ * element in order, with one batched lookup and validation pass.
+**/
+bool tm_readv(shared_t, tx_t, tm_vec_t const*, size_t);
+bool tm_writev(shared_t, tx_t, tm_vec_t const*, size_t);
+
+/** Early release: drop the reads of the transaction lying within the given
+ * range from its read set, so that later changes to the range no longer abort
+ * it. The caller guarantees the transaction's outcome does not depend on them.
+ * @return Whether the whole transaction can continue
+**/
+bool tm_release(shared_t, tx_t, void const*, size_t);
+
+/** Transaction body run by 'tm_run'.
+ * @param shared Shared memory region
+ * @param tx     Current attempt
+ * @param context Opaque context given to 'tm_run'
+ * @return 'false' as soon as an operation on 'tx' returned 'false' (the attempt is then over), 'true' otherwise
+**/
+typedef bool (*tm_body_t)(shared_t, tx_t, void*);
+
+/** Run a transaction to commit: begin, run the body, end, and retry on abort
+ * after the library's own backoff.
+ * @param attempts Number of attempts made, including the committed one (optional, may be NULL)
+ * @return Whether the transaction committed, 'false' only if one could not be begun
+**/
+bool tm_run(shared_t, bool, tm_body_t, void*, size_t*);
+
+/** Single-word read-modify-write operations, each one a transaction of its
+ * own (linearizable with the other transactions) that cannot abort.
+ * @param shared  Shared memory region
+ * @param address Address of the (8-byte aligned) word in shared memory
+ * @return Value of the word before the operation
+**/
+uint64_t tm_fetch_add(shared_t, void*, uint64_t);
+uint64_t tm_compare_swap(shared_t, void*, uint64_t, uint64_t);
+uint64_t tm_swap(shared_t, void*, uint64_t);
+
+/** Hints given when beginning a transaction, each one optional (0: unknown).
+**/
+typedef struct tm_hints {
+    size_t   reads;    // Expected number of reads
+    size_t   writes;   // Expected number of writes
+    int      priority; // Priority over conflicting transactions, higher is stronger
+    uint32_t site;     // ID of the code site the transaction comes from
+} tm_hints_t;
+
+/** Counterpart of 'tm_begin' with hints, which the library may use or ignore.
+ * @param hints Hints for the transaction (optional, may be NULL)
+**/
+tx_t tm_begin_hinted(shared_t, bool, tm_hints_t const*);
+
+/** Statistics of the transactions begun with a given site ID.
+**/
+typedef struct tm_site_stats {
+    uint64_t commits; // Committed transactions
+    uint64_t aborts;  // Aborted attempts
+    uint64_t reads;   // Largest read set of a committed transaction
+    uint64_t writes;  // Largest write set of a committed transaction
+} tm_site_stats_t;
+
+/** Get the statistics of a site (sites may share statistics).
+ * @return Whether the library keeps statistics for the site
+**/
+bool tm_get_site_stats(shared_t, uint32_t, tm_site_stats_t*);
+
+typedef int tm_abort_t;
+static tm_abort_t const none_abort              = 0; // No abort
+static tm_abort_t const read_locked_abort       = 1; // A read found a stripe locked by another transaction
+static tm_abort_t const read_version_abort      = 2; // A read found a stripe written after the transaction began
+static tm_abort_t const commit_locked_abort     = 3; // The commit could not lock a stripe held by another transaction
+static tm_abort_t const commit_validation_abort = 4; // The commit found a stripe of the read set changed or locked
+static tm_abort_t const nomem_abort             = 5; // The library ran out of memory for the transaction
+static tm_abort_t const invalid_abort           = 6; // Invalid operation (e.g. a write in a read-only transaction)
+
+/** Diagnostics of an abort.
+**/
+typedef struct tm_abort_info {
+    tm_abort_t  reason;  // Reason of the abort
+    void const* address; // Start of the conflicting stripe (NULL if none)
+    uint64_t    stripe;  // Index of the conflicting stripe (if any)
+    uint64_t    owner;   // Library-specific ID of the transaction holding the stripe (0 if none or unknown)
+} tm_abort_info_t;
+
+/** Get the diagnostics of the last transaction of the calling thread that aborted.
+ * @param info Diagnostics to fill
+ * @return Whether a transaction of the calling thread aborted so far
+**/
+bool tm_last_abort(tm_abort_info_t*);
+
+/** Write the event counters the library keeps for the region as a JSON object,
+ * like 'snprintf' (truncated to the given size, null-terminated if not empty).
+ * @param shared Shared memory region
+ * @param buffer Target buffer (may be NULL if the size is 0)
+ * @param size   Size of the buffer (in bytes)
+ * @return Length of the whole JSON text, 0 if the library keeps no counters
+**/
+size_t tm_stats_json(shared_t, char*, size_t);
+
+/** Switch the recording of events (for libraries with an event trace) on or off, for every region.
+ * Switching on is refused if the library has nowhere to write the events (e.g. no 'TM_TRACE' file for 301090).
+ * @param enabled Whether to record events
+ * @return Whether events were recorded before the call, 'false' if refused
+**/
+bool tm_set_tracing(bool);
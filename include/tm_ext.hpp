@@ -0,0 +1,96 @@
+/**
+ * @file   tm_ext.hpp
+ * @author agent <agent@local>
+ *
+ * @section LICENSE
+ *
+ * Copyright © 2026 agent.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * any later version. Please see https://gnu.org/licenses/gpl.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * @section DESCRIPTION
+ *
+ * Optional extensions to the interface of "tm.hpp" (C++ version), see "tm_ext.h".
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tm.hpp"
+
+// -------------------------------------------------------------------------- //
+
+using tm_sink_t = bool (*)(void*, void const*, size_t);
+using tm_body_t = bool (*)(shared_t, tx_t, void*);
+
+struct tm_snapshot_segment {
+    uint64_t offset; // Offset of the segment from the start of the first segment
+    uint64_t size;   // Size of the segment (in bytes), followed by its content
+};
+
+struct tm_hints {
+    size_t   reads;    // Expected number of reads
+    size_t   writes;   // Expected number of writes
+    int      priority; // Priority over conflicting transactions, higher is stronger
+    uint32_t site;     // ID of the code site the transaction comes from
+};
+
+struct tm_site_stats {
+    uint64_t commits; // Committed transactions
+    uint64_t aborts;  // Aborted attempts
+    uint64_t reads;   // Largest read set of a committed transaction
+    uint64_t writes;  // Largest write set of a committed transaction
+};
+
+enum class Abort: int {
+    none              = 0, // No abort
+    read_locked       = 1, // A read found a stripe locked by another transaction
+    read_version      = 2, // A read found a stripe written after the transaction began
+    commit_locked     = 3, // The commit could not lock a stripe held by another transaction
+    commit_validation = 4, // The commit found a stripe of the read set changed or locked
+    nomem             = 5, // The library ran out of memory for the transaction
+    invalid           = 6  // Invalid operation (e.g. a write in a read-only transaction)
+};
+
+struct tm_abort_info {
+    Abort       reason;  // Reason of the abort
+    void const* address; // Start of the conflicting stripe (null if none)
+    uint64_t    stripe;  // Index of the conflicting stripe (if any)
+    uint64_t    owner;   // Library-specific ID of the transaction holding the stripe (0 if none or unknown)
+};
+
+struct tm_vec {
+    void*  shared; // Address in shared memory
+    void*  local;  // Private buffer (target of a read, source of a write)
+    size_t size;   // Size of the access (in bytes)
+};
+
+// -------------------------------------------------------------------------- //
+
+extern "C" {
+    bool tm_snapshot(shared_t, tm_sink_t, void*) noexcept;
+    bool tm_read_range(shared_t, tx_t, void const*, size_t, void*) noexcept;
+    bool tm_write_range(shared_t, tx_t, void const*, size_t, void*) noexcept;
+    bool tm_readv(shared_t, tx_t, tm_vec const*, size_t) noexcept;
+    bool tm_writev(shared_t, tx_t, tm_vec const*, size_t) noexcept;
+    bool tm_release(shared_t, tx_t, void const*, size_t) noexcept;
+    bool tm_run(shared_t, bool, tm_body_t, void*, size_t*) noexcept;
+    uint64_t tm_fetch_add(shared_t, void*, uint64_t) noexcept;
+    uint64_t tm_compare_swap(shared_t, void*, uint64_t, uint64_t) noexcept;
+    uint64_t tm_swap(shared_t, void*, uint64_t) noexcept;
+    tx_t tm_begin_hinted(shared_t, bool, tm_hints const*) noexcept;
+    bool tm_get_site_stats(shared_t, uint32_t, tm_site_stats*) noexcept;
+    bool tm_last_abort(tm_abort_info*) noexcept;
+    size_t tm_stats_json(shared_t, char*, size_t) noexcept;
+    bool tm_set_tracing(bool) noexcept;
+}
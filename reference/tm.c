@@ -38,6 +38,8 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#include <sys/mman.h>
 #if (defined(__i386__) || defined(__x86_64__)) && defined(USE_MM_PAUSE)
     #include <xmmintrin.h>
 #else
@@ -350,6 +352,106 @@ static void lock_release_shared(struct lock_t* lock) {
 
 // -------------------------------------------------------------------------- //
 
+/** Backing of the first segment, selected at region creation with the 'TM_HUGE_PAGES' environment variable.
+**/
+enum backing {
+    backing_heap,    // 'posix_memalign' (unset or "off")
+    backing_thp,     // Anonymous mapping aligned on and advised for transparent huge pages ("thp")
+    backing_hugetlb  // Anonymous mapping from the hugetlbfs pool, falling back to 'backing_thp' ("hugetlb")
+};
+
+/** Get the size of a huge page.
+ * @return Huge page size (in bytes)
+**/
+static size_t huge_page_size() {
+    size_t size = 0;
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo) {
+        char line[128];
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (sscanf(line, "Hugepagesize: %zu kB", &size) == 1) {
+                size *= 1024;
+                break;
+            }
+        }
+        fclose(meminfo);
+    }
+    return size > 0 ? size : (2ul << 20);
+}
+
+/** Get the requested backing of the first segment.
+ * @return Requested backing
+**/
+static enum backing backing_requested() {
+    char const* mode = getenv("TM_HUGE_PAGES");
+    if (mode && strcmp(mode, "thp") == 0)
+        return backing_thp;
+    if (mode && strcmp(mode, "hugetlb") == 0)
+        return backing_hugetlb;
+    return backing_heap;
+}
+
+/** Allocate memory with the requested backing, falling back to the next one on failure (hugetlb, thp, then heap).
+ * @param backing Requested backing, actual backing (output)
+ * @param size    Size to allocate (in bytes)
+ * @param align   Alignment of the allocation (in bytes)
+ * @param mapped  Size of the mapping (output, unused for 'backing_heap')
+ * @return Allocated memory, 'NULL' on failure
+**/
+static void* backing_alloc(enum backing* backing, size_t size, size_t align, size_t* mapped) {
+    size_t page = huge_page_size();
+    size_t length = (size + page - 1) / page * page;
+#ifdef MAP_HUGETLB
+    if (*backing == backing_hugetlb) {
+        void* start = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (start != MAP_FAILED) {
+            *mapped = length;
+            return start;
+        }
+        *backing = backing_thp;
+    }
+#else
+    if (*backing == backing_hugetlb)
+        *backing = backing_thp;
+#endif
+    if (*backing == backing_thp) {
+        void* start = mmap(NULL, length + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (start != MAP_FAILED) { // Trim the mapping to a huge page-aligned range
+            uintptr_t aligned = ((uintptr_t) start + page - 1) / page * page;
+            size_t head = aligned - (uintptr_t) start;
+            if (head > 0)
+                munmap(start, head);
+            if (page - head > 0)
+                munmap((void*) (aligned + length), page - head);
+#ifdef MADV_HUGEPAGE
+            madvise((void*) aligned, length, MADV_HUGEPAGE);
+#endif
+            *mapped = length;
+            return (void*) aligned;
+        }
+        *backing = backing_heap;
+    }
+    void* start;
+    if (unlikely(posix_memalign(&start, align, size) != 0))
+        return NULL;
+    return start;
+}
+
+/** Free memory allocated with 'backing_alloc'.
+ * @param backing Actual backing
+ * @param start   Allocated memory
+ * @param mapped  Size of the mapping
+**/
+static void backing_free(enum backing backing, void* start, size_t mapped) {
+    if (backing == backing_heap) {
+        free(start);
+    } else {
+        munmap(start, mapped);
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
 static const tx_t read_only_tx  = UINTPTR_MAX - 10;
 static const tx_t read_write_tx = UINTPTR_MAX - 11;
 
@@ -361,6 +463,8 @@ struct region {
     size_t align;       // Claimed alignment of the shared memory region (in bytes)
     size_t align_alloc; // Actual alignment of the memory allocations (in bytes)
     size_t delta_alloc; // Space to add at the beginning of the segment for the link chain (in bytes)
+    enum backing backing; // Backing of the first segment
+    size_t mapped;        // Size of the mapping of the first segment (in bytes, unused for 'backing_heap')
 };
 
 shared_t tm_create(size_t size, size_t align) {
@@ -369,12 +473,14 @@ shared_t tm_create(size_t size, size_t align) {
         return invalid_shared;
     }
     size_t align_alloc = align < sizeof(void*) ? sizeof(void*) : align; // Also satisfy alignment requirement of 'struct link'
-    if (unlikely(posix_memalign(&(region->start), align_alloc, size) != 0)) {
+    region->backing = backing_requested();
+    region->start = backing_alloc(&(region->backing), size, align_alloc, &(region->mapped));
+    if (unlikely(!region->start)) {
         free(region);
         return invalid_shared;
     }
     if (unlikely(!lock_init(&(region->lock)))) {
-        free(region->start);
+        backing_free(region->backing, region->start, region->mapped);
         free(region);
         return invalid_shared;
     }
@@ -397,9 +503,9 @@ void tm_destroy(shared_t shared) {
         link_remove(alloc);
         free(alloc);
     }
-    free(region->start);
-    free(region);
+    backing_free(region->backing, region->start, region->mapped);
     lock_cleanup(&(region->lock));
+    free(region);
 }
 
 void* tm_start(shared_t shared) {